@@ -660,6 +660,36 @@ typedef struct Clay_ScrollContainerData {
     bool found;
 } Clay_ScrollContainerData;
 
+// Counts of lookups in Clay's internal text measurement cache since Clay_Initialize().
+typedef struct Clay_MeasureTextCacheStats {
+    // Text elements whose measurement was already cached.
+    uint64_t hits;
+    // Text elements that had to be measured, calling the measure text function once per word or the batch function once.
+    uint64_t misses;
+} Clay_MeasureTextCacheStats;
+
+// A word of a string handed to the function set with Clay_SetMeasureTextBatchFunction().
+typedef struct Clay_MeasureTextWord {
+    // Where the word starts, in bytes from the start of the string.
+    int32_t startOffset;
+    // Length of the word in bytes, 0 for the empty words around consecutive spaces and line breaks.
+    int32_t length;
+    // Filled in by the batch function, 0 for empty words.
+    float width;
+} Clay_MeasureTextWord;
+
+// Counts of Clay_EndLayout() calls since Clay_Initialize(), see Clay_SetLayoutReuseEnabled().
+typedef struct Clay_LayoutReuseStats {
+    // Frames declared exactly like the one before, whose layout and render commands were reused.
+    uint64_t reused;
+    // Frames that were laid out.
+    uint64_t computed;
+    // In frames that were laid out, elements whose children got the sizes they had in the previous layout, once per axis.
+    uint64_t reusedSizings;
+    // In frames that were laid out, text elements that got the lines they were wrapped into in the previous layout.
+    uint64_t reusedTextWraps;
+} Clay_LayoutReuseStats;
+
 // Bounding box and other data for a specific UI element.
 typedef struct Clay_ElementData {
     // The rectangle that encloses this UI element, with the position relative to the root of the layout.
@@ -894,6 +924,11 @@ CLAY_DLL_EXPORT Clay_ScrollContainerData Clay_GetScrollContainerData(Clay_Elemen
 // - measureTextFunction is a user provided function that adheres to the interface Clay_Dimensions (Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
 // - userData is a pointer that will be transparently passed through when the measureTextFunction is called.
 CLAY_DLL_EXPORT void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData), void *userData);
+// Binds a callback function that Clay will call once per string instead of once per word, used instead of the measureTextFunction while set.
+// - measureTextBatchFunction gets the whole string and its words in order, fills in the width of every word and returns the dimensions of a single space.
+//   Every word is taken to be as tall as the space. Pass NULL to go back to the measureTextFunction.
+// - userData is a pointer that will be transparently passed through when the measureTextBatchFunction is called.
+CLAY_DLL_EXPORT void Clay_SetMeasureTextBatchFunction(Clay_Dimensions (*measureTextBatchFunction)(Clay_StringSlice text, Clay_MeasureTextWord *words, int32_t wordCount, Clay_TextElementConfig *config, void *userData), void *userData);
 // Experimental - Used in cases where Clay needs to integrate with a system that manages its own scrolling containers externally.
 // Please reach out if you plan to use this function, as it may be subject to change.
 CLAY_DLL_EXPORT void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData);
@@ -918,6 +953,18 @@ CLAY_DLL_EXPORT int32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 CLAY_DLL_EXPORT void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount);
 // Resets Clay's internal text measurement cache. Useful if font mappings have changed or fonts have been reloaded.
 CLAY_DLL_EXPORT void Clay_ResetMeasureTextCache(void);
+// Returns how many text measurements were served from Clay's internal cache and how many missed it.
+CLAY_DLL_EXPORT Clay_MeasureTextCacheStats Clay_GetMeasureTextCacheStats(void);
+// Enables and disables layout reuse. When enabled, every element is hashed together with everything declared inside it.
+// A frame that declares exactly what the previous one did gets the previous layout and render commands back without
+// laying anything out. Otherwise, an element declared the same way and given the same size as in the previous layout
+// gets its children sized the same way without sizing them, and unchanged text given the same width keeps its lines
+// without wrapping it again. Positions and render commands are still worked out for every element.
+// Frames with the debug view open or with external scroll handling are always laid out from scratch.
+// This state is retained and does not need to be set each frame. Disabled by default.
+CLAY_DLL_EXPORT void Clay_SetLayoutReuseEnabled(bool enabled);
+// Returns how many frames reused the previous layout, how many were laid out, and how much of those reused the previous layout.
+CLAY_DLL_EXPORT Clay_LayoutReuseStats Clay_GetLayoutReuseStats(void);
 
 // Internal API functions required by macros ----------------------
 
@@ -945,6 +992,16 @@ extern uint32_t Clay__debugViewWidth;
 // IMPLEMENTATION --------------------------
 // -----------------------------------------
 #ifdef CLAY_IMPLEMENTATION
+
+// Profiling hooks around the phases of Clay_EndLayout(). Define them before the implementation
+// is compiled to record spans, by default they compile to nothing.
+// CLAY__TRACE_BEGIN(name) opens a span with a string literal name, CLAY__TRACE_END() closes the innermost one.
+#ifndef CLAY__TRACE_BEGIN
+#define CLAY__TRACE_BEGIN(name)
+#endif
+#ifndef CLAY__TRACE_END
+#define CLAY__TRACE_END()
+#endif
 #undef CLAY_IMPLEMENTATION
 
 #ifndef CLAY__NULL
@@ -1071,6 +1128,8 @@ bool Clay__Array_AddCapacityCheck(int32_t length, int32_t capacity);
 
 CLAY__ARRAY_DEFINE(bool, Clay__boolArray)
 CLAY__ARRAY_DEFINE(int32_t, Clay__int32_tArray)
+CLAY__ARRAY_DEFINE(uint64_t, Clay__uint64_tArray)
+CLAY__ARRAY_DEFINE(float, Clay__floatArray)
 CLAY__ARRAY_DEFINE(char, Clay__charArray)
 CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_ElementId, Clay_ElementIdArray)
 CLAY__ARRAY_DEFINE(Clay_LayoutConfig, Clay__LayoutConfigArray)
@@ -1183,33 +1242,38 @@ typedef struct { // todo get this struct into a single cache line
     void *hoverFunctionUserData;
     int32_t nextIndex;
     uint32_t generation;
+    // Index into layoutElements the last time this element was declared
+    int32_t layoutElementIndex;
     Clay__DebugElementData *debugData;
 } Clay_LayoutElementHashMapItem;
 
 CLAY__ARRAY_DEFINE(Clay_LayoutElementHashMapItem, Clay__LayoutElementHashMapItemArray)
 
-typedef struct {
-    int32_t startOffset;
-    int32_t length;
-    float width;
-    int32_t next;
-} Clay__MeasuredWord;
+// Laid out like the words handed to the batch function, so it can measure them in place
+typedef Clay_MeasureTextWord Clay__MeasuredWord;
 
 CLAY__ARRAY_DEFINE(Clay__MeasuredWord, Clay__MeasuredWordArray)
 
 typedef struct {
     Clay_Dimensions unwrappedDimensions;
+    // The words of one measurement are contiguous in measuredWords
     int32_t measuredWordsStartIndex;
+    int32_t measuredWordsCount;
     float minWidth;
+    float spaceWidth;
     bool containsNewlines;
-    // Hash map data
-    uint32_t id;
-    int32_t nextIndex;
-    uint32_t generation;
 } Clay__MeasureTextCacheItem;
 
 CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
 
+// Probed part of a measure text cache slot, kept apart from the item so a lookup reads 8 bytes per probe
+typedef struct {
+    uint32_t id; // 0 marks an empty slot
+    uint32_t generation;
+} Clay__MeasureTextCacheSlot;
+
+CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheSlot, Clay__MeasureTextCacheSlotArray)
+
 typedef struct {
     Clay_LayoutElement *layoutElement;
     Clay_Vector2 position;
@@ -1228,6 +1292,20 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__LayoutElementTreeRoot, Clay__LayoutElementTreeRootArray)
 
+// What an element was laid out as in the last frame that was laid out, see Clay_SetLayoutReuseEnabled()
+typedef struct {
+    // Hash of the element's declaration and of everything declared inside it
+    uint64_t hash;
+    // Width after sizing along the x axis, the width its children were sized to fit in
+    float sizedWidth;
+    Clay_Dimensions dimensions;
+    // Text elements only, their lines in reusableWrappedTextLines
+    int32_t wrappedTextLinesStart;
+    int32_t wrappedTextLinesCount;
+} Clay__ReusableLayoutElement;
+
+CLAY__ARRAY_DEFINE(Clay__ReusableLayoutElement, Clay__ReusableLayoutElementArray)
+
 struct Clay_Context {
     int32_t maxElementCount;
     int32_t maxMeasureTextCacheWordCount;
@@ -1245,8 +1323,15 @@ struct Clay_Context {
     bool externalScrollHandlingEnabled;
     uint32_t debugSelectedElementId;
     uint32_t generation;
+    Clay_MeasureTextCacheStats measureTextCacheStats;
+    bool layoutReuseEnabled;
+    // Hash of the last frame that was laid out, 0 when its layout can't be reused
+    uint64_t reusableDeclarationHash;
+    int32_t reusableRenderCommandCount;
+    Clay_LayoutReuseStats layoutReuseStats;
     uintptr_t arenaResetOffset;
     void *measureTextUserData;
+    void *measureTextBatchUserData;
     void *queryScrollOffsetUserData;
     Clay_Arena internalArena;
     // Layout Elements / Render Commands
@@ -1259,6 +1344,11 @@ struct Clay_Context {
     Clay__int32_tArray aspectRatioElementIndexes;
     Clay__int32_tArray reusableElementIndexBuffer;
     Clay__int32_tArray layoutElementClipElementIds;
+    // Filled in while layout reuse is enabled. The hash covers the element's declaration and everything declared
+    // inside it, the previous index is where it was the last time it was declared.
+    Clay__uint64_tArray layoutElementHashes;
+    Clay__int32_tArray layoutElementPreviousIndexes;
+    Clay__floatArray layoutElementSizedWidths;
     // Configs
     Clay__LayoutConfigArray layoutConfigs;
     Clay__ElementConfigArray elementConfigs;
@@ -1275,19 +1365,29 @@ struct Clay_Context {
     Clay__WrappedTextLineArray wrappedTextLines;
     Clay__LayoutElementTreeNodeArray layoutElementTreeNodeArray1;
     Clay__LayoutElementTreeRootArray layoutElementTreeRoots;
+    Clay__LayoutElementTreeRootArray layoutElementTreeRootBuffer;
     Clay__LayoutElementHashMapItemArray layoutElementsHashMapInternal;
     Clay__int32_tArray layoutElementsHashMap;
-    Clay__MeasureTextCacheItemArray measureTextHashMapInternal;
-    Clay__int32_tArray measureTextHashMapInternalFreeList;
-    Clay__int32_tArray measureTextHashMap;
+    // Open addressing with linear probing, a power of two slots and at most half of them used.
+    // Slot i's item is measureTextCacheItems[i].
+    Clay__MeasureTextCacheSlotArray measureTextCacheSlots;
+    Clay__MeasureTextCacheItemArray measureTextCacheItems;
+    int32_t measureTextCacheCount;
+    // Words are appended as text is measured. Evicted items leave holes that are compacted away once it fills.
     Clay__MeasuredWordArray measuredWords;
-    Clay__int32_tArray measuredWordsFreeList;
+    // At the first word of each run, the slot owning it, or minus the run's length once evicted
+    Clay__int32_tArray measuredWordOwners;
+    int32_t measuredWordsEvicted;
     Clay__int32_tArray openClipElementStack;
     Clay_ElementIdArray pointerOverIds;
     Clay__ScrollContainerDataInternalArray scrollContainerDatas;
     Clay__boolArray treeNodeVisited;
     Clay__charArray dynamicStringData;
     Clay__DebugElementDataArray debugElementData;
+    // Every layout element of the last frame that was laid out and the lines its text was wrapped into, empty when
+    // there is nothing to reuse
+    Clay__ReusableLayoutElementArray reusableLayoutElements;
+    Clay__WrappedTextLineArray reusableWrappedTextLines;
 };
 
 Clay_Context* Clay__Context_Allocate_Arena(Clay_Arena *arena) {
@@ -1313,6 +1413,7 @@ Clay_String Clay__WriteStringToCharBuffer(Clay__charArray *buffer, Clay_String s
     __attribute__((import_module("clay"), import_name("queryScrollOffsetFunction"))) Clay_Vector2 Clay__QueryScrollOffset(uint32_t elementId, void *userData);
 #else
     Clay_Dimensions (*Clay__MeasureText)(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
+    Clay_Dimensions (*Clay__MeasureTextBatch)(Clay_StringSlice text, Clay_MeasureTextWord *words, int32_t wordCount, Clay_TextElementConfig *config, void *userData);
     Clay_Vector2 (*Clay__QueryScrollOffset)(uint32_t elementId, void *userData);
 #endif
 
@@ -1557,24 +1658,220 @@ uint32_t Clay__HashStringContentsWithConfig(Clay_String *text, Clay_TextElementC
     return hash + 1; // Reserve the hash result of zero as "null id"
 }
 
-Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__MeasuredWord *previousWord) {
-    Clay_Context* context = Clay_GetCurrentContext();
-    if (context->measuredWordsFreeList.length > 0) {
-        uint32_t newItemIndex = Clay__int32_tArray_GetValue(&context->measuredWordsFreeList, (int)context->measuredWordsFreeList.length - 1);
-        context->measuredWordsFreeList.length--;
-        Clay__MeasuredWordArray_Set(&context->measuredWords, (int)newItemIndex, word);
-        previousWord->next = (int32_t)newItemIndex;
-        return Clay__MeasuredWordArray_Get(&context->measuredWords, (int)newItemIndex);
-    } else {
-        previousWord->next = (int32_t)context->measuredWords.length;
-        return Clay__MeasuredWordArray_Add(&context->measuredWords, word);
+void Clay__MixDeclarationHash(uint64_t *hash, uint64_t value) {
+    uint64_t mixed = (*hash ^ value) * 0x9E3779B97F4A7C15ull;
+    *hash = mixed ^ (mixed >> 29);
+}
+
+void Clay__MixDeclarationHashFloat(uint64_t *hash, float value) {
+    union { float value; uint32_t bits; } converted = { .value = value };
+    Clay__MixDeclarationHash(hash, converted.bits);
+}
+
+void Clay__MixDeclarationHashPointer(uint64_t *hash, const void *pointer) {
+    Clay__MixDeclarationHash(hash, (uintptr_t)pointer);
+}
+
+void Clay__MixDeclarationHashColor(uint64_t *hash, Clay_Color color) {
+    Clay__MixDeclarationHashFloat(hash, color.r);
+    Clay__MixDeclarationHashFloat(hash, color.g);
+    Clay__MixDeclarationHashFloat(hash, color.b);
+    Clay__MixDeclarationHashFloat(hash, color.a);
+}
+
+void Clay__MixDeclarationHashSizingAxis(uint64_t *hash, Clay_SizingAxis axis) {
+    Clay__MixDeclarationHash(hash, axis.type);
+    // The percent shares its bits with the min
+    Clay__MixDeclarationHashFloat(hash, axis.size.minMax.min);
+    Clay__MixDeclarationHashFloat(hash, axis.size.minMax.max);
+}
+
+// Field by field, padding bytes in the declaration hold whatever was on the stack
+void Clay__MixDeclarationHashElement(uint64_t *hash, const Clay_ElementDeclaration *declaration) {
+    const Clay_LayoutConfig *layout = &declaration->layout;
+    Clay__MixDeclarationHashSizingAxis(hash, layout->sizing.width);
+    Clay__MixDeclarationHashSizingAxis(hash, layout->sizing.height);
+    Clay__MixDeclarationHash(hash, (uint64_t)layout->padding.left | (uint64_t)layout->padding.right << 16 | (uint64_t)layout->padding.top << 32 | (uint64_t)layout->padding.bottom << 48);
+    Clay__MixDeclarationHash(hash, (uint64_t)layout->childGap | (uint64_t)layout->childAlignment.x << 16 | (uint64_t)layout->childAlignment.y << 24 | (uint64_t)layout->layoutDirection << 32);
+
+    Clay__MixDeclarationHashColor(hash, declaration->backgroundColor);
+    Clay__MixDeclarationHashFloat(hash, declaration->cornerRadius.topLeft);
+    Clay__MixDeclarationHashFloat(hash, declaration->cornerRadius.topRight);
+    Clay__MixDeclarationHashFloat(hash, declaration->cornerRadius.bottomLeft);
+    Clay__MixDeclarationHashFloat(hash, declaration->cornerRadius.bottomRight);
+    Clay__MixDeclarationHashFloat(hash, declaration->aspectRatio.aspectRatio);
+    Clay__MixDeclarationHashPointer(hash, declaration->image.imageData);
+
+    const Clay_FloatingElementConfig *floating = &declaration->floating;
+    Clay__MixDeclarationHashFloat(hash, floating->offset.x);
+    Clay__MixDeclarationHashFloat(hash, floating->offset.y);
+    Clay__MixDeclarationHashFloat(hash, floating->expand.width);
+    Clay__MixDeclarationHashFloat(hash, floating->expand.height);
+    Clay__MixDeclarationHash(hash, (uint64_t)floating->parentId | (uint64_t)(uint16_t)floating->zIndex << 32);
+    Clay__MixDeclarationHash(hash, (uint64_t)floating->attachPoints.element | (uint64_t)floating->attachPoints.parent << 8 | (uint64_t)floating->pointerCaptureMode << 16 | (uint64_t)floating->attachTo << 24 | (uint64_t)floating->clipTo << 32);
+
+    Clay__MixDeclarationHashPointer(hash, declaration->custom.customData);
+    Clay__MixDeclarationHash(hash, (uint64_t)declaration->clip.horizontal | (uint64_t)declaration->clip.vertical << 1);
+    Clay__MixDeclarationHashFloat(hash, declaration->clip.childOffset.x);
+    Clay__MixDeclarationHashFloat(hash, declaration->clip.childOffset.y);
+
+    const Clay_BorderElementConfig *border = &declaration->border;
+    Clay__MixDeclarationHashColor(hash, border->color);
+    Clay__MixDeclarationHash(hash, (uint64_t)border->width.left | (uint64_t)border->width.right << 16 | (uint64_t)border->width.top << 32 | (uint64_t)border->width.bottom << 48);
+    Clay__MixDeclarationHash(hash, border->width.betweenChildren);
+    Clay__MixDeclarationHashPointer(hash, declaration->userData);
+}
+
+// Render commands point at the text, so the pointer counts as well as the contents
+void Clay__MixDeclarationHashText(uint64_t *hash, const Clay_String *text, const Clay_TextElementConfig *config) {
+    Clay__MixDeclarationHashPointer(hash, text->chars);
+    Clay__MixDeclarationHash(hash, (uint64_t)(uint32_t)text->length | (uint64_t)text->isStaticallyAllocated << 32);
+    if (!text->isStaticallyAllocated) {
+        Clay__MixDeclarationHash(hash, Clay__HashData((const uint8_t *)text->chars, (size_t)text->length));
+    }
+    Clay__MixDeclarationHashPointer(hash, config->userData);
+    Clay__MixDeclarationHashColor(hash, config->textColor);
+    Clay__MixDeclarationHash(hash, (uint64_t)config->fontId | (uint64_t)config->fontSize << 16 | (uint64_t)config->letterSpacing << 32 | (uint64_t)config->lineHeight << 48);
+    Clay__MixDeclarationHash(hash, (uint64_t)config->wrapMode | (uint64_t)config->textAlignment << 8);
+}
+
+uint32_t Clay__MeasureTextCacheHome(uint32_t id, uint32_t mask) {
+    return (uint32_t)(((uint64_t)id * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+int32_t Clay__FindMeasureTextCacheSlot(Clay_Context *context, uint32_t id) {
+    Clay__MeasureTextCacheSlot *slots = context->measureTextCacheSlots.internalArray;
+    uint32_t mask = (uint32_t)context->measureTextCacheSlots.capacity - 1;
+    uint32_t slot = Clay__MeasureTextCacheHome(id, mask);
+    while (slots[slot].id != 0 && slots[slot].id != id) {
+        slot = (slot + 1) & mask;
+    }
+    return (int32_t)slot;
+}
+
+// Backward shift deletion, which keeps every probe sequence intact without tombstones
+void Clay__RemoveMeasureTextCacheSlot(Clay_Context *context, int32_t hole) {
+    Clay__MeasureTextCacheSlot *slots = context->measureTextCacheSlots.internalArray;
+    Clay__MeasureTextCacheItem *items = context->measureTextCacheItems.internalArray;
+    int32_t *owners = context->measuredWordOwners.internalArray;
+    if (items[hole].measuredWordsCount > 0) {
+        owners[items[hole].measuredWordsStartIndex] = -items[hole].measuredWordsCount;
+        context->measuredWordsEvicted += items[hole].measuredWordsCount;
+    }
+
+    uint32_t mask = (uint32_t)context->measureTextCacheSlots.capacity - 1;
+    uint32_t empty = (uint32_t)hole;
+    for (uint32_t slot = (empty + 1) & mask; slots[slot].id != 0; slot = (slot + 1) & mask) {
+        uint32_t home = Clay__MeasureTextCacheHome(slots[slot].id, mask);
+        // Only items whose probe sequence passes over the empty slot may move into it
+        bool passesEmpty = empty <= slot ? (home <= empty || home > slot) : (home <= empty && home > slot);
+        if (passesEmpty) {
+            slots[empty] = slots[slot];
+            items[empty] = items[slot];
+            if (items[empty].measuredWordsCount > 0) {
+                owners[items[empty].measuredWordsStartIndex] = (int32_t)empty;
+            }
+            empty = slot;
+        }
+    }
+    slots[empty] = CLAY__INIT(Clay__MeasureTextCacheSlot) CLAY__DEFAULT_STRUCT;
+    context->measureTextCacheCount--;
+}
+
+// Drops the items that haven't been used in a few frames
+void Clay__EvictStaleMeasureTextCacheItems(Clay_Context *context) {
+    Clay__MeasureTextCacheSlot *slots = context->measureTextCacheSlots.internalArray;
+    int32_t slot = 0;
+    while (slot < context->measureTextCacheSlots.capacity) {
+        // Removing shifts a later item into this slot, so it's checked again
+        if (slots[slot].id != 0 && context->generation - slots[slot].generation > 2) {
+            Clay__RemoveMeasureTextCacheSlot(context, slot);
+        } else {
+            slot++;
+        }
+    }
+}
+
+// Slides the words that are still owned down over the holes evicted items left
+void Clay__CompactMeasuredWords(Clay_Context *context) {
+    Clay__MeasuredWord *words = context->measuredWords.internalArray;
+    int32_t *owners = context->measuredWordOwners.internalArray;
+    int32_t writeIndex = 0;
+    int32_t readIndex = 0;
+    while (readIndex < context->measuredWords.length) {
+        int32_t owner = owners[readIndex];
+        if (owner < 0) {
+            readIndex -= owner;
+            continue;
+        }
+        Clay__MeasureTextCacheItem *item = &context->measureTextCacheItems.internalArray[owner];
+        for (int32_t i = 0; i < item->measuredWordsCount; ++i) {
+            words[writeIndex + i] = words[readIndex + i];
+        }
+        owners[writeIndex] = owner;
+        item->measuredWordsStartIndex = writeIndex;
+        writeIndex += item->measuredWordsCount;
+        readIndex += item->measuredWordsCount;
+    }
+    context->measuredWords.length = writeIndex;
+    context->measuredWordsEvicted = 0;
+}
+
+void Clay__ClearMeasureTextCache(Clay_Context *context) {
+    for (int32_t i = 0; i < context->measureTextCacheSlots.capacity; ++i) {
+        context->measureTextCacheSlots.internalArray[i] = CLAY__INIT(Clay__MeasureTextCacheSlot) CLAY__DEFAULT_STRUCT;
+    }
+    context->measureTextCacheCount = 0;
+    context->measuredWords.length = 0;
+    context->measuredWordsEvicted = 0;
+}
+
+// The number of words Clay__MeasureTextCached() splits the text into
+int32_t Clay__CountMeasuredWords(Clay_String *text) {
+    int32_t count = 0;
+    int32_t start = 0;
+    for (int32_t end = 0; end < text->length; ++end) {
+        char current = text->chars[end];
+        if (current == ' ') {
+            count++;
+            start = end + 1;
+        } else if (current == '\n') {
+            count += end - start > 0 ? 2 : 1;
+            start = end + 1;
+        }
+    }
+    return text->length - start > 0 ? count + 1 : count;
+}
+
+#ifndef CLAY_WASM
+// Splits the text into the words Clay__MeasureTextCached() adds, straight into the slots they're added to, and has the
+// batch function measure them all at once. Newlines get an empty word like they do in measuredWords.
+Clay_Dimensions Clay__MeasureWordsBatched(Clay_Context *context, Clay_String *text, Clay_TextElementConfig *config, Clay__MeasuredWord *words) {
+    int32_t count = 0;
+    int32_t start = 0;
+    for (int32_t end = 0; end < text->length; ++end) {
+        char current = text->chars[end];
+        if (current == ' ' || current == '\n') {
+            if (current == ' ' || end - start > 0) {
+                words[count++] = CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start };
+            }
+            if (current == '\n') {
+                words[count++] = CLAY__INIT(Clay__MeasuredWord) { .startOffset = end + 1 };
+            }
+            start = end + 1;
+        }
+    }
+    if (text->length - start > 0) {
+        words[count++] = CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = text->length - start };
     }
+    return Clay__MeasureTextBatch(CLAY__INIT(Clay_StringSlice) { .length = text->length, .chars = text->chars, .baseChars = text->chars }, words, count, config, context->measureTextBatchUserData);
 }
+#endif
 
 Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config) {
     Clay_Context* context = Clay_GetCurrentContext();
     #ifndef CLAY_WASM
-    if (!Clay__MeasureText) {
+    if (!Clay__MeasureText && !Clay__MeasureTextBatch) {
         if (!context->booleanWarnings.textMeasurementFunctionNotSet) {
             context->booleanWarnings.textMeasurementFunctionNotSet = true;
             context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
@@ -1586,62 +1883,66 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     }
     #endif
     uint32_t id = Clay__HashStringContentsWithConfig(text, config);
-    uint32_t hashBucket = id % (context->maxMeasureTextCacheWordCount / 32);
-    int32_t elementIndexPrevious = 0;
-    int32_t elementIndex = context->measureTextHashMap.internalArray[hashBucket];
-    while (elementIndex != 0) {
-        Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
-        if (hashEntry->id == id) {
-            hashEntry->generation = context->generation;
-            return hashEntry;
-        }
-        // This element hasn't been seen in a few frames, delete the hash map item
-        if (context->generation - hashEntry->generation > 2) {
-            // Add all the measured words that were included in this measurement to the freelist
-            int32_t nextWordIndex = hashEntry->measuredWordsStartIndex;
-            while (nextWordIndex != -1) {
-                Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, nextWordIndex);
-                Clay__int32_tArray_Add(&context->measuredWordsFreeList, nextWordIndex);
-                nextWordIndex = measuredWord->next;
-            }
+    id = id == 0 ? 1 : id; // 0 marks an empty slot
+    int32_t slot = Clay__FindMeasureTextCacheSlot(context, id);
+    if (context->measureTextCacheSlots.internalArray[slot].id == id) {
+        context->measureTextCacheSlots.internalArray[slot].generation = context->generation;
+        context->measureTextCacheStats.hits++;
+        return &context->measureTextCacheItems.internalArray[slot];
+    }
 
-            int32_t nextIndex = hashEntry->nextIndex;
-            Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, elementIndex, CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 });
-            Clay__int32_tArray_Add(&context->measureTextHashMapInternalFreeList, elementIndex);
-            if (elementIndexPrevious == 0) {
-                context->measureTextHashMap.internalArray[hashBucket] = nextIndex;
-            } else {
-                Clay__MeasureTextCacheItem *previousHashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious);
-                previousHashEntry->nextIndex = nextIndex;
-            }
-            elementIndex = nextIndex;
-        } else {
-            elementIndexPrevious = elementIndex;
-            elementIndex = hashEntry->nextIndex;
+    context->measureTextCacheStats.misses++;
+    int32_t wordCount = Clay__CountMeasuredWords(text);
+    bool itemsFull = context->measureTextCacheCount >= context->maxElementCount;
+    bool wordsFull = context->measuredWords.length + wordCount > context->measuredWords.capacity;
+    if (itemsFull || wordsFull) {
+        Clay__EvictStaleMeasureTextCacheItems(context);
+        if (context->measuredWordsEvicted > 0 && context->measuredWords.length + wordCount > context->measuredWords.capacity) {
+            Clay__CompactMeasuredWords(context);
+        }
+        slot = Clay__FindMeasureTextCacheSlot(context, id);
+    }
+    if (context->measureTextCacheCount >= context->maxElementCount) {
+        if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                    .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+                    .errorText = CLAY_STRING("Clay ran out of capacity while attempting to measure text elements. Try using Clay_SetMaxElementCount() with a higher value."),
+                    .userData = context->errorHandler.userData });
+            context->booleanWarnings.maxTextMeasureCacheExceeded = true;
+        }
+        return &Clay__MeasureTextCacheItem_DEFAULT;
+    }
+    if (context->measuredWords.length + wordCount > context->measuredWords.capacity) {
+        if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
+                .errorText = CLAY_STRING("Clay has run out of space in it's internal text measurement cache. Try using Clay_SetMaxMeasureTextCacheWordCount() (default 16384, with 1 unit storing 1 measured word)."),
+                .userData = context->errorHandler.userData });
+            context->booleanWarnings.maxTextMeasureCacheExceeded = true;
         }
+        return &Clay__MeasureTextCacheItem_DEFAULT;
     }
 
-    int32_t newItemIndex = 0;
-    Clay__MeasureTextCacheItem newCacheItem = { .measuredWordsStartIndex = -1, .id = id, .generation = context->generation };
-    Clay__MeasureTextCacheItem *measured = NULL;
-    if (context->measureTextHashMapInternalFreeList.length > 0) {
-        newItemIndex = Clay__int32_tArray_GetValue(&context->measureTextHashMapInternalFreeList, context->measureTextHashMapInternalFreeList.length - 1);
-        context->measureTextHashMapInternalFreeList.length--;
-        Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, newItemIndex, newCacheItem);
-        measured = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, newItemIndex);
+    context->measureTextCacheSlots.internalArray[slot] = CLAY__INIT(Clay__MeasureTextCacheSlot) { .id = id, .generation = context->generation };
+    context->measureTextCacheCount++;
+    Clay__MeasureTextCacheItem *measured = &context->measureTextCacheItems.internalArray[slot];
+    *measured = CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = context->measuredWords.length, .measuredWordsCount = wordCount };
+    if (wordCount > 0) {
+        context->measuredWordOwners.internalArray[measured->measuredWordsStartIndex] = slot;
+    }
+
+    #ifdef CLAY_WASM
+    bool batched = false;
+    #else
+    bool batched = Clay__MeasureTextBatch != NULL;
+    #endif
+    float wordHeight = 0;
+    if (batched) {
+        Clay_Dimensions space = Clay__MeasureWordsBatched(context, text, config, &context->measuredWords.internalArray[measured->measuredWordsStartIndex]);
+        measured->spaceWidth = space.width;
+        wordHeight = space.height;
     } else {
-        if (context->measureTextHashMapInternal.length == context->measureTextHashMapInternal.capacity - 1) {
-            if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
-                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                        .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
-                        .errorText = CLAY_STRING("Clay ran out of capacity while attempting to measure text elements. Try using Clay_SetMaxElementCount() with a higher value."),
-                        .userData = context->errorHandler.userData });
-                context->booleanWarnings.maxTextMeasureCacheExceeded = true;
-            }
-            return &Clay__MeasureTextCacheItem_DEFAULT;
-        }
-        measured = Clay__MeasureTextCacheItemArray_Add(&context->measureTextHashMapInternal, newCacheItem);
-        newItemIndex = context->measureTextHashMapInternal.length - 1;
+        measured->spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
     }
 
     int32_t start = 0;
@@ -1649,39 +1950,29 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     float lineWidth = 0;
     float measuredWidth = 0;
     float measuredHeight = 0;
-    float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
-    Clay__MeasuredWord tempWord = { .next = -1 };
-    Clay__MeasuredWord *previousWord = &tempWord;
+    float spaceWidth = measured->spaceWidth;
     while (end < text->length) {
-        if (context->measuredWords.length == context->measuredWords.capacity - 1) {
-            if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
-                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                    .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
-                    .errorText = CLAY_STRING("Clay has run out of space in it's internal text measurement cache. Try using Clay_SetMaxMeasureTextCacheWordCount() (default 16384, with 1 unit storing 1 measured word)."),
-                    .userData = context->errorHandler.userData });
-                context->booleanWarnings.maxTextMeasureCacheExceeded = true;
-            }
-            return &Clay__MeasureTextCacheItem_DEFAULT;
-        }
         char current = text->chars[end];
         if (current == ' ' || current == '\n') {
             int32_t length = end - start;
             Clay_Dimensions dimensions = CLAY__DEFAULT_STRUCT;
             if (length > 0) {
-                dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config, context->measureTextUserData);
+                dimensions = batched
+                    ? CLAY__INIT(Clay_Dimensions) { context->measuredWords.internalArray[context->measuredWords.length].width, wordHeight }
+                    : Clay__MeasureText(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config, context->measureTextUserData);
             }
             measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
             measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
             if (current == ' ') {
                 dimensions.width += spaceWidth;
-                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length + 1, .width = dimensions.width, .next = -1 }, previousWord);
+                Clay__MeasuredWordArray_Add(&context->measuredWords, CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length + 1, .width = dimensions.width });
                 lineWidth += dimensions.width;
             }
             if (current == '\n') {
                 if (length > 0) {
-                    previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length, .width = dimensions.width, .next = -1 }, previousWord);
+                    Clay__MeasuredWordArray_Add(&context->measuredWords, CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length, .width = dimensions.width });
                 }
-                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = end + 1, .length = 0, .width = 0, .next = -1 }, previousWord);
+                Clay__MeasuredWordArray_Add(&context->measuredWords, CLAY__INIT(Clay__MeasuredWord) { .startOffset = end + 1, .length = 0, .width = 0 });
                 lineWidth += dimensions.width;
                 measuredWidth = CLAY__MAX(lineWidth, measuredWidth);
                 measured->containsNewlines = true;
@@ -1692,23 +1983,18 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         end++;
     }
     if (end - start > 0) {
-        Clay_Dimensions dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
-        Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
+        Clay_Dimensions dimensions = batched
+            ? CLAY__INIT(Clay_Dimensions) { context->measuredWords.internalArray[context->measuredWords.length].width, wordHeight }
+            : Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
+        Clay__MeasuredWordArray_Add(&context->measuredWords, CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width });
         lineWidth += dimensions.width;
         measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
         measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
     }
     measuredWidth = CLAY__MAX(lineWidth, measuredWidth) - config->letterSpacing;
 
-    measured->measuredWordsStartIndex = tempWord.next;
     measured->unwrappedDimensions.width = measuredWidth;
     measured->unwrappedDimensions.height = measuredHeight;
-
-    if (elementIndexPrevious != 0) {
-        Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious)->nextIndex = newItemIndex;
-    } else {
-        context->measureTextHashMap.internalArray[hashBucket] = newItemIndex;
-    }
     return measured;
 }
 
@@ -1718,10 +2004,14 @@ bool Clay__PointIsInsideRect(Clay_Vector2 point, Clay_BoundingBox rect) {
 
 Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
     Clay_Context* context = Clay_GetCurrentContext();
+    int32_t layoutElementIndex = (int32_t)(layoutElement - context->layoutElements.internalArray);
+    if (context->layoutReuseEnabled) {
+        Clay__int32_tArray_Set(&context->layoutElementPreviousIndexes, layoutElementIndex, -1);
+    }
     if (context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1) {
         return NULL;
     }
-    Clay_LayoutElementHashMapItem item = { .elementId = elementId, .layoutElement = layoutElement, .nextIndex = -1, .generation = context->generation + 1 };
+    Clay_LayoutElementHashMapItem item = { .elementId = elementId, .layoutElement = layoutElement, .nextIndex = -1, .generation = context->generation + 1, .layoutElementIndex = layoutElementIndex };
     uint32_t hashBucket = elementId.id % context->layoutElementsHashMap.capacity;
     int32_t hashItemPrevious = -1;
     int32_t hashItemIndex = context->layoutElementsHashMap.internalArray[hashBucket];
@@ -1733,6 +2023,10 @@ Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Cl
                 hashItem->elementId = elementId; // Make sure to copy this across. If the stringId reference has changed, we should update the hash item to use the new one.
                 hashItem->generation = context->generation + 1;
                 hashItem->layoutElement = layoutElement;
+                if (context->layoutReuseEnabled) {
+                    Clay__int32_tArray_Set(&context->layoutElementPreviousIndexes, layoutElementIndex, hashItem->layoutElementIndex);
+                }
+                hashItem->layoutElementIndex = layoutElementIndex;
                 hashItem->debugData->collision = false;
                 hashItem->onHoverFunction = NULL;
                 hashItem->hoverFunctionUserData = 0;
@@ -1836,7 +2130,6 @@ void Clay__CloseElement(void) {
             context->openClipElementStack.length--;
         }
     }
-
     float leftRightPadding = (float)(layoutConfig->padding.left + layoutConfig->padding.right);
     float topBottomPadding = (float)(layoutConfig->padding.top + layoutConfig->padding.bottom);
 
@@ -1920,6 +2213,15 @@ void Clay__CloseElement(void) {
     // Close the currently open element
     int32_t closingElementIndex = Clay__int32_tArray_RemoveSwapback(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1);
 
+    if (context->layoutReuseEnabled) {
+        uint64_t *hash = &context->layoutElementHashes.internalArray[closingElementIndex];
+        // Closing marks where the children end, ids alone don't tell siblings from children
+        Clay__MixDeclarationHash(hash, (uint64_t)openLayoutElement->childrenOrTextContent.children.length | (uint64_t)openLayoutElement->floatingChildrenCount << 32);
+        if (context->openLayoutElementStack.length > 1) {
+            Clay__MixDeclarationHash(&context->layoutElementHashes.internalArray[Clay__int32_tArray_GetValue(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1)], *hash);
+        }
+    }
+
     // Get the currently open parent
     openLayoutElement = Clay__GetOpenLayoutElement();
 
@@ -2008,6 +2310,11 @@ void Clay__OpenElement(void) {
     Clay_LayoutElement* openLayoutElement = Clay_LayoutElementArray_Add(&context->layoutElements, layoutElement);
     Clay__int32_tArray_Add(&context->openLayoutElementStack, context->layoutElements.length - 1);
     Clay__GenerateIdForAnonymousElement(openLayoutElement);
+    if (context->layoutReuseEnabled) {
+        uint64_t hash = 0;
+        Clay__MixDeclarationHash(&hash, openLayoutElement->id);
+        Clay__uint64_tArray_Set(&context->layoutElementHashes, context->layoutElements.length - 1, hash);
+    }
     if (context->openClipElementStack.length > 0) {
         Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, Clay__int32_tArray_GetValue(&context->openClipElementStack, (int)context->openClipElementStack.length - 1));
     } else {
@@ -2027,6 +2334,11 @@ void Clay__OpenElementWithId(Clay_ElementId elementId) {
     Clay__int32_tArray_Add(&context->openLayoutElementStack, context->layoutElements.length - 1);
     Clay__AddHashMapItem(elementId, openLayoutElement);
     Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
+    if (context->layoutReuseEnabled) {
+        uint64_t hash = 0;
+        Clay__MixDeclarationHash(&hash, elementId.id);
+        Clay__uint64_tArray_Set(&context->layoutElementHashes, context->layoutElements.length - 1, hash);
+    }
     if (context->openClipElementStack.length > 0) {
         Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, Clay__int32_tArray_GetValue(&context->openClipElementStack, (int)context->openClipElementStack.length - 1));
     } else {
@@ -2056,6 +2368,13 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
     textElement->id = elementId.id;
     Clay__AddHashMapItem(elementId, textElement);
     Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
+    if (context->layoutReuseEnabled) {
+        uint64_t hash = 0;
+        Clay__MixDeclarationHash(&hash, elementId.id);
+        Clay__MixDeclarationHashText(&hash, &text, textConfig);
+        Clay__uint64_tArray_Set(&context->layoutElementHashes, context->layoutElements.length - 1, hash);
+        Clay__MixDeclarationHash(&context->layoutElementHashes.internalArray[Clay__int32_tArray_GetValue(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1)], hash);
+    }
     Clay_Dimensions textDimensions = { .width = textMeasured->unwrappedDimensions.width, .height = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textMeasured->unwrappedDimensions.height };
     textElement->dimensions = textDimensions;
     textElement->minDimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->minWidth, .height = textDimensions.height };
@@ -2071,6 +2390,9 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
 void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    if (context->layoutReuseEnabled) {
+        Clay__MixDeclarationHashElement(&context->layoutElementHashes.internalArray[Clay__int32_tArray_GetValue(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1)], declaration);
+    }
     openLayoutElement->layoutConfig = Clay__StoreLayoutConfig(declaration->layout);
     if ((declaration->layout.sizing.width.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.width.size.percent > 1) || (declaration->layout.sizing.height.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.height.size.percent > 1)) {
         context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
@@ -2206,6 +2528,7 @@ void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementTreeRootBuffer = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->textElementData = Clay__TextElementDataArray_Allocate_Arena(maxElementCount, arena);
@@ -2216,6 +2539,9 @@ void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     context->openClipElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementHashes = Clay__uint64_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementPreviousIndexes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSizedWidths = Clay__floatArray_Allocate_Arena(maxElementCount, arena);
     context->dynamicStringData = Clay__charArray_Allocate_Arena(maxElementCount, arena);
 }
 
@@ -2228,13 +2554,18 @@ void Clay__InitializePersistentMemory(Clay_Context* context) {
     context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(100, arena);
     context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementsHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(maxElementCount, arena);
-    context->measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
-    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    int32_t measureTextCacheCapacity = 1;
+    while (measureTextCacheCapacity < maxElementCount * 2) {
+        measureTextCacheCapacity *= 2;
+    }
+    context->measureTextCacheSlots = Clay__MeasureTextCacheSlotArray_Allocate_Arena(measureTextCacheCapacity, arena);
+    context->measureTextCacheItems = Clay__MeasureTextCacheItemArray_Allocate_Arena(measureTextCacheCapacity, arena);
     context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
+    context->measuredWordOwners = Clay__int32_tArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
     context->pointerOverIds = Clay_ElementIdArray_Allocate_Arena(maxElementCount, arena);
     context->debugElementData = Clay__DebugElementDataArray_Allocate_Arena(maxElementCount, arena);
+    context->reusableLayoutElements = Clay__ReusableLayoutElementArray_Allocate_Arena(maxElementCount, arena);
+    context->reusableWrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
     context->arenaResetOffset = arena->nextAllocation;
 }
 
@@ -2245,6 +2576,20 @@ bool Clay__FloatEqual(float left, float right) {
     return subtracted < CLAY__EPSILON && subtracted > -CLAY__EPSILON;
 }
 
+// Where the element was in the last frame that was laid out if it and everything inside it were declared the same way
+// there, -1 otherwise. Elements inside it are at the same offset from it in both frames.
+int32_t Clay__ReusableLayoutElementIndex(int32_t layoutElementIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->reusableLayoutElements.length == 0) {
+        return -1;
+    }
+    int32_t reusableIndex = context->layoutElementPreviousIndexes.internalArray[layoutElementIndex];
+    if (reusableIndex < 0 || reusableIndex >= context->reusableLayoutElements.length || context->reusableLayoutElements.internalArray[reusableIndex].hash != context->layoutElementHashes.internalArray[layoutElementIndex]) {
+        return -1;
+    }
+    return reusableIndex;
+}
+
 void Clay__SizeContainersAlongAxis(bool xAxis) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
@@ -2296,6 +2641,30 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
         for (int32_t i = 0; i < bfsBuffer.length; ++i) {
             int32_t parentIndex = Clay__int32_tArray_GetValue(&bfsBuffer, i);
             Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
+
+            // Declared the same way and given the same size as last frame, so its children are sized the same way too
+            int32_t reusableIndex = Clay__ReusableLayoutElementIndex(parentIndex);
+            if (reusableIndex != -1) {
+                Clay__ReusableLayoutElement *reusable = &context->reusableLayoutElements.internalArray[reusableIndex];
+                if (parent->dimensions.width == reusable->sizedWidth && (xAxis || parent->dimensions.height == reusable->dimensions.height)) {
+                    for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
+                        int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
+                        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
+                        Clay__ReusableLayoutElement *reusableChild = &context->reusableLayoutElements.internalArray[childElementIndex + reusableIndex - parentIndex];
+                        if (xAxis) {
+                            childElement->dimensions.width = reusableChild->sizedWidth;
+                        } else {
+                            childElement->dimensions.height = reusableChild->dimensions.height;
+                        }
+                        if (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) && childElement->childrenOrTextContent.children.length > 0) {
+                            Clay__int32_tArray_Add(&bfsBuffer, childElementIndex);
+                        }
+                    }
+                    context->layoutReuseStats.reusedSizings++;
+                    continue;
+                }
+            }
+
             Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
             int32_t growContainerCount = 0;
             float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
@@ -2528,20 +2897,89 @@ bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
            (boundingBox->y + boundingBox->height < 0);
 }
 
+// Stable radix sort on the zIndex, one byte per pass, so roots with equal zIndex stay in declaration order
+void Clay__SortLayoutElementTreeRoots(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeRootArray *roots = &context->layoutElementTreeRoots;
+    bool sorted = true;
+    for (int32_t i = 1; i < roots->length && sorted; ++i) {
+        sorted = roots->internalArray[i - 1].zIndex <= roots->internalArray[i].zIndex;
+    }
+    if (sorted) {
+        return;
+    }
+
+    // Flipping the sign bit orders the int16_t zIndex as an unsigned key
+    int32_t bucketStarts[2][257] = CLAY__DEFAULT_STRUCT;
+    for (int32_t i = 0; i < roots->length; ++i) {
+        uint16_t key = (uint16_t)((uint16_t)roots->internalArray[i].zIndex ^ 0x8000u);
+        bucketStarts[0][(key & 0xFF) + 1]++;
+        bucketStarts[1][(key >> 8) + 1]++;
+    }
+
+    Clay__LayoutElementTreeRoot *source = roots->internalArray;
+    Clay__LayoutElementTreeRoot *target = context->layoutElementTreeRootBuffer.internalArray;
+    for (int32_t pass = 0; pass < 2; ++pass) {
+        int32_t shift = pass * 8;
+        uint16_t firstKey = (uint16_t)((uint16_t)source[0].zIndex ^ 0x8000u);
+        // Every root has the same byte here, the pass wouldn't move anything
+        if (bucketStarts[pass][((firstKey >> shift) & 0xFF) + 1] == roots->length) {
+            continue;
+        }
+        for (int32_t bucket = 0; bucket < 256; ++bucket) {
+            bucketStarts[pass][bucket + 1] += bucketStarts[pass][bucket];
+        }
+        for (int32_t i = 0; i < roots->length; ++i) {
+            uint16_t key = (uint16_t)((uint16_t)source[i].zIndex ^ 0x8000u);
+            target[bucketStarts[pass][(key >> shift) & 0xFF]++] = source[i];
+        }
+        Clay__LayoutElementTreeRoot *swap = source;
+        source = target;
+        target = swap;
+    }
+    if (source != roots->internalArray) {
+        for (int32_t i = 0; i < roots->length; ++i) {
+            roots->internalArray[i] = source[i];
+        }
+    }
+}
+
 void Clay__CalculateFinalLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
     // Calculate sizing along the X axis
+    CLAY__TRACE_BEGIN("size x");
     Clay__SizeContainersAlongAxis(true);
+    if (context->layoutReuseEnabled) {
+        for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+            context->layoutElementSizedWidths.internalArray[i] = context->layoutElements.internalArray[i].dimensions.width;
+        }
+    }
+    CLAY__TRACE_END();
 
     // Wrap text
+    CLAY__TRACE_BEGIN("wrap");
     for (int32_t textElementIndex = 0; textElementIndex < context->textElementData.length; ++textElementIndex) {
         Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, textElementIndex);
         textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
         Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)textElementData->elementIndex);
         Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(containerElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
+        float lineHeight = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textElementData->preferredDimensions.height;
+        // The same text wrapped to the same width as last frame breaks into the same lines
+        int32_t reusableIndex = Clay__ReusableLayoutElementIndex(textElementData->elementIndex);
+        if (reusableIndex != -1) {
+            Clay__ReusableLayoutElement *reusable = &context->reusableLayoutElements.internalArray[reusableIndex];
+            if (containerElement->dimensions.width == reusable->sizedWidth && context->wrappedTextLines.length + reusable->wrappedTextLinesCount <= context->wrappedTextLines.capacity) {
+                for (int32_t lineIndex = 0; lineIndex < reusable->wrappedTextLinesCount; ++lineIndex) {
+                    Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, context->reusableWrappedTextLines.internalArray[reusable->wrappedTextLinesStart + lineIndex]);
+                }
+                textElementData->wrappedLines.length = reusable->wrappedTextLinesCount;
+                containerElement->dimensions.height = lineHeight * (float)reusable->wrappedTextLinesCount;
+                context->layoutReuseStats.reusedTextWraps++;
+                continue;
+            }
+        }
         Clay__MeasureTextCacheItem *measureTextCacheItem = Clay__MeasureTextCached(&textElementData->text, textConfig);
         float lineWidth = 0;
-        float lineHeight = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textElementData->preferredDimensions.height;
         int32_t lineLengthChars = 0;
         int32_t lineStartOffset = 0;
         if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
@@ -2549,9 +2987,10 @@ void Clay__CalculateFinalLayout(void) {
             textElementData->wrappedLines.length++;
             continue;
         }
-        float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, textConfig, context->measureTextUserData).width;
+        float spaceWidth = measureTextCacheItem->spaceWidth;
         int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
-        while (wordIndex != -1) {
+        int32_t wordsEnd = measureTextCacheItem->measuredWordsStartIndex + measureTextCacheItem->measuredWordsCount;
+        while (wordIndex < wordsEnd) {
             if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1) {
                 break;
             }
@@ -2560,7 +2999,7 @@ void Clay__CalculateFinalLayout(void) {
             if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
                 Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { measuredWord->width, lineHeight }, { .length = measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
                 textElementData->wrappedLines.length++;
-                wordIndex = measuredWord->next;
+                wordIndex++;
                 lineStartOffset = measuredWord->startOffset + measuredWord->length;
             }
             // measuredWord->length == 0 means a newline character
@@ -2570,7 +3009,7 @@ void Clay__CalculateFinalLayout(void) {
                 Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth + (finalCharIsSpace ? -spaceWidth : 0), lineHeight }, { .length = lineLengthChars + (finalCharIsSpace ? -1 : 0), .chars = &textElementData->text.chars[lineStartOffset] } });
                 textElementData->wrappedLines.length++;
                 if (lineLengthChars == 0 || measuredWord->length == 0) {
-                    wordIndex = measuredWord->next;
+                    wordIndex++;
                 }
                 lineWidth = 0;
                 lineLengthChars = 0;
@@ -2578,7 +3017,7 @@ void Clay__CalculateFinalLayout(void) {
             } else {
                 lineWidth += measuredWord->width + textConfig->letterSpacing;
                 lineLengthChars += measuredWord->length;
-                wordIndex = measuredWord->next;
+                wordIndex++;
             }
         }
         if (lineLengthChars > 0) {
@@ -2587,6 +3026,7 @@ void Clay__CalculateFinalLayout(void) {
         }
         containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
     }
+    CLAY__TRACE_END();
 
     // Scale vertical heights according to aspect ratio
     for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
@@ -2645,7 +3085,9 @@ void Clay__CalculateFinalLayout(void) {
     }
 
     // Calculate sizing along the Y axis
+    CLAY__TRACE_BEGIN("size y");
     Clay__SizeContainersAlongAxis(false);
+    CLAY__TRACE_END();
 
     // Scale horizontal widths according to aspect ratio
     for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
@@ -2655,20 +3097,12 @@ void Clay__CalculateFinalLayout(void) {
     }
 
     // Sort tree roots by z-index
-    int32_t sortMax = context->layoutElementTreeRoots.length - 1;
-    while (sortMax > 0) { // todo dumb bubble sort
-        for (int32_t i = 0; i < sortMax; ++i) {
-            Clay__LayoutElementTreeRoot current = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
-            Clay__LayoutElementTreeRoot next = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i + 1);
-            if (next.zIndex < current.zIndex) {
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i, next);
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i + 1, current);
-            }
-        }
-        sortMax--;
-    }
+    CLAY__TRACE_BEGIN("sort");
+    Clay__SortLayoutElementTreeRoots();
+    CLAY__TRACE_END();
 
     // Calculate final positions and generate render commands
+    CLAY__TRACE_BEGIN("commands");
     context->renderCommands.length = 0;
     dfsBuffer.length = 0;
     for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
@@ -2802,23 +3236,17 @@ void Clay__CalculateFinalLayout(void) {
                     hashMapItem->boundingBox = currentElementBoundingBox;
                 }
 
+                // Clip configs first and border configs last, the others keep their order
                 int32_t sortedConfigIndexes[20];
-                for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
-                    sortedConfigIndexes[elementConfigIndex] = elementConfigIndex;
-                }
-                sortMax = currentElement->elementConfigs.length - 1;
-                while (sortMax > 0) { // todo dumb bubble sort
-                    for (int32_t i = 0; i < sortMax; ++i) {
-                        int32_t current = sortedConfigIndexes[i];
-                        int32_t next = sortedConfigIndexes[i + 1];
-                        Clay__ElementConfigType currentType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, current)->type;
-                        Clay__ElementConfigType nextType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, next)->type;
-                        if (nextType == CLAY__ELEMENT_CONFIG_TYPE_CLIP || currentType == CLAY__ELEMENT_CONFIG_TYPE_BORDER) {
-                            sortedConfigIndexes[i] = next;
-                            sortedConfigIndexes[i + 1] = current;
+                int32_t sortedConfigCount = 0;
+                for (int32_t rank = 0; rank < 3; ++rank) {
+                    for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
+                        Clay__ElementConfigType type = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, elementConfigIndex)->type;
+                        int32_t configRank = type == CLAY__ELEMENT_CONFIG_TYPE_CLIP ? 0 : type == CLAY__ELEMENT_CONFIG_TYPE_BORDER ? 2 : 1;
+                        if (configRank == rank) {
+                            sortedConfigIndexes[sortedConfigCount++] = elementConfigIndex;
                         }
                     }
-                    sortMax--;
                 }
 
                 bool emitRectangle = false;
@@ -3138,6 +3566,51 @@ void Clay__CalculateFinalLayout(void) {
             Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__HashNumber(rootElement->id, rootElement->childrenOrTextContent.children.length + 11).id, .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
         }
     }
+    CLAY__TRACE_END();
+}
+
+void Clay__DropReusableLayout(Clay_Context *context) {
+    context->reusableDeclarationHash = 0;
+    context->reusableLayoutElements.length = 0;
+}
+
+// The ephemeral arrays are allocated at the same offsets every frame and only Clay__CalculateFinalLayout() writes
+// render commands, so those of the last frame that was laid out are still in place. The elements were declared
+// again though, and get their final dimensions back from the copy.
+void Clay__SaveFinalLayout(uint64_t declarationHash) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        Clay__ReusableLayoutElement *reusable = &context->reusableLayoutElements.internalArray[i];
+        reusable->hash = context->layoutElementHashes.internalArray[i];
+        reusable->sizedWidth = context->layoutElementSizedWidths.internalArray[i];
+        reusable->dimensions = context->layoutElements.internalArray[i].dimensions;
+    }
+    for (int32_t i = 0; i < context->textElementData.length; ++i) {
+        Clay__TextElementData *textElementData = &context->textElementData.internalArray[i];
+        Clay__ReusableLayoutElement *reusable = &context->reusableLayoutElements.internalArray[textElementData->elementIndex];
+        reusable->wrappedTextLinesStart = (int32_t)(textElementData->wrappedLines.internalArray - context->wrappedTextLines.internalArray);
+        reusable->wrappedTextLinesCount = textElementData->wrappedLines.length;
+    }
+    for (int32_t i = 0; i < context->wrappedTextLines.length; ++i) {
+        context->reusableWrappedTextLines.internalArray[i] = context->wrappedTextLines.internalArray[i];
+    }
+    context->reusableLayoutElements.length = context->layoutElements.length;
+    context->reusableWrappedTextLines.length = context->wrappedTextLines.length;
+    context->reusableRenderCommandCount = context->renderCommands.length;
+    context->reusableDeclarationHash = declarationHash;
+}
+
+void Clay__ReuseFinalLayout(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    CLAY__TRACE_BEGIN("reuse");
+    for (int32_t i = 0; i < context->reusableLayoutElements.length; ++i) {
+        context->layoutElements.internalArray[i].dimensions = context->reusableLayoutElements.internalArray[i].dimensions;
+    }
+    Clay__SortLayoutElementTreeRoots();
+    // Scroll containers that were declared are open again, their content size and bounding box haven't changed
+    context->renderCommands.length = context->reusableRenderCommandCount;
+    context->layoutReuseStats.reused++;
+    CLAY__TRACE_END();
 }
 
 CLAY_WASM_EXPORT("Clay_GetPointerOverIds")
@@ -3953,6 +4426,13 @@ void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_Str
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__MeasureText = measureTextFunction;
     context->measureTextUserData = userData;
+    Clay__DropReusableLayout(context);
+}
+void Clay_SetMeasureTextBatchFunction(Clay_Dimensions (*measureTextBatchFunction)(Clay_StringSlice text, Clay_MeasureTextWord *words, int32_t wordCount, Clay_TextElementConfig *config, void *userData), void *userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__MeasureTextBatch = measureTextBatchFunction;
+    context->measureTextBatchUserData = userData;
+    Clay__DropReusableLayout(context);
 }
 void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4060,10 +4540,7 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
     for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
         context->layoutElementsHashMap.internalArray[i] = -1;
     }
-    for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
-        context->measureTextHashMap.internalArray[i] = 0;
-    }
-    context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    Clay__ClearMeasureTextCache(context);
     context->layoutDimensions = layoutDimensions;
     return context;
 }
@@ -4261,7 +4738,27 @@ Clay_RenderCommandArray Clay_EndLayout(void) {
                 .errorText = CLAY_STRING("There were still open layout elements when EndLayout was called. This results from an unequal number of calls to Clay__OpenElement and Clay__CloseElement."),
                 .userData = context->errorHandler.userData });
     }
-    Clay__CalculateFinalLayout();
+    bool reusable = context->layoutReuseEnabled && !context->debugModeEnabled && !context->externalScrollHandlingEnabled && !context->booleanWarnings.maxElementsExceeded;
+    uint64_t declarationHash = 0;
+    if (reusable) {
+        // Everything is declared inside the root, floating elements included
+        declarationHash = context->layoutElementHashes.internalArray[0];
+        Clay__MixDeclarationHash(&declarationHash, (uint64_t)context->disableCulling);
+        // Never 0, that marks a layout which can't be reused
+        declarationHash |= 1;
+    } else {
+        Clay__DropReusableLayout(context);
+    }
+    if (reusable && declarationHash == context->reusableDeclarationHash) {
+        Clay__ReuseFinalLayout();
+    } else {
+        // Subtrees declared and sized like in the previous layout still reuse its results
+        Clay__CalculateFinalLayout();
+        context->layoutReuseStats.computed++;
+        if (reusable) {
+            Clay__SaveFinalLayout(declarationHash);
+        }
+    }
     return context->renderCommands;
 }
 
@@ -4413,16 +4910,28 @@ void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount)
 CLAY_WASM_EXPORT("Clay_ResetMeasureTextCache")
 void Clay_ResetMeasureTextCache(void) {
     Clay_Context* context = Clay_GetCurrentContext();
-    context->measureTextHashMapInternal.length = 0;
-    context->measureTextHashMapInternalFreeList.length = 0;
-    context->measureTextHashMap.length = 0;
-    context->measuredWords.length = 0;
-    context->measuredWordsFreeList.length = 0;
-    
-    for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
-        context->measureTextHashMap.internalArray[i] = 0;
-    }
-    context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    Clay__ClearMeasureTextCache(context);
+    // Text is measured again, which may lay it out differently
+    Clay__DropReusableLayout(context);
+}
+
+CLAY_WASM_EXPORT("Clay_GetMeasureTextCacheStats")
+Clay_MeasureTextCacheStats Clay_GetMeasureTextCacheStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->measureTextCacheStats;
+}
+
+CLAY_WASM_EXPORT("Clay_SetLayoutReuseEnabled")
+void Clay_SetLayoutReuseEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->layoutReuseEnabled = enabled;
+    Clay__DropReusableLayout(context);
+}
+
+CLAY_WASM_EXPORT("Clay_GetLayoutReuseStats")
+Clay_LayoutReuseStats Clay_GetLayoutReuseStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->layoutReuseStats;
 }
 
 #endif // CLAY_IMPLEMENTATION
@@ -0,0 +1,132 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "event_loop.h"
+
+#include <raylib.h>
+
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+
+// Part of the GLFW copy built into raylib's desktop platform. Weak so other platforms
+// still link, they just lose the ability to wake a blocking wait from another thread.
+[[gnu::weak]] void glfwPostEmptyEvent(void);
+
+
+static uint64_t drain(int fd) {
+    uint64_t count = 0;
+    if (read(fd, &count, sizeof count) != sizeof count)
+        return 0;
+
+    return count;
+}
+
+static void* waker_main(void* arg) {
+    EventLoop* loop = (EventLoop*) arg;
+
+    struct pollfd fds[2] = {
+        { .fd = loop->wakeup_fd, .events = POLLIN },
+        { .fd = loop->stop_fd, .events = POLLIN },
+    };
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (fds[1].revents & POLLIN)
+            break;
+
+        // The frame that wakes up rebuilds everything, how many wakeups came doesn't matter
+        drain(loop->wakeup_fd);
+        glfwPostEmptyEvent();
+    }
+
+    return nullptr;
+}
+
+
+bool event_loop_init(EventLoop* loop) {
+    *loop = (EventLoop) {
+        .wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK),
+        .stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK),
+    };
+
+    if (loop->wakeup_fd < 0 || loop->stop_fd < 0) {
+        event_loop_close(loop);
+        return false;
+    }
+
+    if (glfwPostEmptyEvent != nullptr)
+        loop->waker_running = pthread_create(&loop->waker, nullptr, waker_main, loop) == 0;
+
+    return true;
+}
+
+void event_loop_close(EventLoop* loop) {
+    if (loop->waker_running) {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = write(loop->stop_fd, &one, sizeof one);
+        pthread_join(loop->waker, nullptr);
+    }
+
+    if (loop->wakeup_fd >= 0)
+        close(loop->wakeup_fd);
+    if (loop->stop_fd >= 0)
+        close(loop->stop_fd);
+
+    *loop = (EventLoop) { .wakeup_fd = -1, .stop_fd = -1 };
+}
+
+
+void event_loop_wakeup(EventLoop* loop) {
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(loop->wakeup_fd, &one, sizeof one);
+}
+
+void event_loop_animate_for(EventLoop* loop, double seconds) {
+    loop->animate_until = fmax(loop->animate_until, GetTime() + seconds);
+}
+
+
+void event_loop_poll(EventLoop* loop) {
+    // The waker thread drains it too, this is for when there is none
+    drain(loop->wakeup_fd);
+}
+
+void event_loop_pick_mode(EventLoop* loop) {
+    // Without the waker thread nothing could interrupt a blocking wait
+    bool waiting = loop->waker_running && GetTime() >= loop->animate_until;
+    if (waiting != loop->waiting) {
+        if (waiting)
+            EnableEventWaiting();
+        else
+            DisableEventWaiting();
+
+        loop->waiting = waiting;
+    }
+}
+
+void event_loop_idle(EventLoop* loop, double frame_time) {
+    event_loop_pick_mode(loop);
+    if (loop->waiting) {
+        // Blocks until the next event
+        PollInputEvents();
+        return;
+    }
+
+    // Sleep on the wakeup fd so a wakeup still cuts the frame short
+    struct pollfd fds[1] = {
+        { .fd = loop->wakeup_fd, .events = POLLIN },
+    };
+    poll(fds, 1, (int) ceil(frame_time * 1000));
+
+    PollInputEvents();
+}
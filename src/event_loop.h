@@ -0,0 +1,40 @@
+#pragma once
+
+#include <pthread.h>
+
+
+// Drives the main loop off events instead of polling: while nothing is animating,
+// raylib blocks in EndDrawing()/PollInputEvents() until input, a resize or an app wakeup
+// arrives. Wakeups are watched by a helper thread that nudges GLFW out of its wait.
+// Scroll momentum and other animations keep frames coming with event_loop_animate_for().
+typedef struct EventLoop {
+    // Write an 8 byte count here (or call event_loop_wakeup()) to wake the UI thread
+    int wakeup_fd;
+    int stop_fd;
+
+    pthread_t waker;
+    bool waker_running;
+
+    // Whether raylib currently blocks waiting for events
+    bool waiting;
+    // Continuous frames are produced until this GetTime() value
+    double animate_until;
+} EventLoop;
+
+
+bool event_loop_init(EventLoop* loop);
+void event_loop_close(EventLoop* loop);
+
+// Thread safe, for whatever produces data the UI shows, like incoming messages
+void event_loop_wakeup(EventLoop* loop);
+
+void event_loop_animate_for(EventLoop* loop, double seconds);
+
+// Drains the wakeups that started this iteration
+void event_loop_poll(EventLoop* loop);
+// Picks blocking or continuous mode for the wait that ends this iteration. Call it after
+// the iteration's input is handled and right before EndDrawing(), so an animation started
+// by that input doesn't wait for the next event.
+void event_loop_pick_mode(EventLoop* loop);
+// Stands in for EndDrawing() on frames that are not presented, picks the mode itself
+void event_loop_idle(EventLoop* loop, double frame_time);
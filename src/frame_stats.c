@@ -0,0 +1,165 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "frame_stats.h"
+
+#include "clay.h"
+
+#include <raylib.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+static const char* PHASE_NAMES[FRAME_PHASE_COUNT] = {
+    [FRAME_PHASE_DECLARE] = "declare",
+    [FRAME_PHASE_FINAL_LAYOUT] = "final layout",
+    [FRAME_PHASE_MEASURE] = "  measure",
+    [FRAME_PHASE_RENDER] = "render",
+    [FRAME_PHASE_PRESENT] = "present",
+};
+
+constexpr int HUD_FONT_SIZE = 20;
+constexpr int HUD_LINE_HEIGHT = 22;
+constexpr int HUD_PADDING = 8;
+constexpr int HUD_WIDTH = 460;
+constexpr int HUD_LABEL_WIDTH = 160;
+constexpr int HUD_COLUMN_WIDTH = 90;
+
+
+static int compare_floats(const void* a, const void* b) {
+    float left = *(const float*) a;
+    float right = *(const float*) b;
+    return (left > right) - (left < right);
+}
+
+
+uint64_t frame_stats_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+void frame_stats_enable(FrameStats* stats, bool enabled) {
+    *stats = (FrameStats) {
+        .enabled = enabled,
+        .measure_cache = Clay_GetMeasureTextCacheStats(),
+    };
+}
+
+void frame_stats_count_commands(FrameStats* stats, Clay_RenderCommandArray renderCommands) {
+    if (!stats->enabled)
+        return;
+
+    memset(stats->command_counts, 0, sizeof(stats->command_counts));
+    for (int32_t idx = 0; idx < renderCommands.length; ++idx) {
+        Clay_RenderCommandType type = renderCommands.internalArray[idx].commandType;
+        if (type <= CLAY_RENDER_COMMAND_TYPE_CUSTOM)
+            stats->command_counts[type] += 1;
+    }
+}
+
+void frame_stats_count_culled(FrameStats* stats, int32_t culled) {
+    if (stats->enabled)
+        stats->culled_commands = culled;
+}
+
+void frame_stats_end_frame(FrameStats* stats) {
+    if (!stats->enabled)
+        return;
+
+    int sample = stats->next_sample;
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; ++phase) {
+        stats->samples[phase][sample] = (float) ((double) stats->elapsed[phase] / 1e6);
+        stats->elapsed[phase] = 0;
+    }
+
+    Clay_MeasureTextCacheStats cache = Clay_GetMeasureTextCacheStats();
+    stats->measure_hits[sample] = cache.hits - stats->measure_cache.hits;
+    stats->measure_misses[sample] = cache.misses - stats->measure_cache.misses;
+    stats->measure_cache = cache;
+
+    stats->next_sample = (sample + 1) % FRAME_STATS_WINDOW;
+    if (stats->sample_count < FRAME_STATS_WINDOW)
+        stats->sample_count += 1;
+}
+
+float frame_stats_percentile(const FrameStats* stats, FramePhase phase, float percentile) {
+    if (stats->sample_count == 0)
+        return 0;
+
+    float sorted[FRAME_STATS_WINDOW];
+    memcpy(sorted, stats->samples[phase], sizeof(float) * (size_t) stats->sample_count);
+    qsort(sorted, (size_t) stats->sample_count, sizeof(float), compare_floats);
+
+    // Nearest rank
+    int rank = (int) ((float) stats->sample_count * percentile + 0.999f) - 1;
+    rank = rank < 0 ? 0 : rank >= stats->sample_count ? stats->sample_count - 1 : rank;
+    return sorted[rank];
+}
+
+void frame_stats_draw_hud(const FrameStats* stats, int x, int y) {
+    int lines = FRAME_PHASE_COUNT + 5;
+    DrawRectangle(x, y, HUD_WIDTH, lines * HUD_LINE_HEIGHT + HUD_PADDING * 2, Fade(BLACK, 0.75f));
+
+    int left = x + HUD_PADDING;
+    int line = y + HUD_PADDING;
+
+    DrawText(TextFormat("ms over %d frames", stats->sample_count), left, line, HUD_FONT_SIZE, LIGHTGRAY);
+    static const char* COLUMNS[3] = { "p50", "p95", "p99" };
+    for (int column = 0; column < 3; ++column) {
+        int column_x = left + HUD_LABEL_WIDTH + HUD_COLUMN_WIDTH * column;
+        DrawText(COLUMNS[column], column_x, line, HUD_FONT_SIZE, LIGHTGRAY);
+    }
+    line += HUD_LINE_HEIGHT;
+
+    static const float PERCENTILES[3] = { 0.50f, 0.95f, 0.99f };
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; ++phase) {
+        DrawText(PHASE_NAMES[phase], left, line, HUD_FONT_SIZE, RAYWHITE);
+        for (int column = 0; column < 3; ++column) {
+            float milliseconds = frame_stats_percentile(stats, (FramePhase) phase, PERCENTILES[column]);
+            int column_x = left + HUD_LABEL_WIDTH + HUD_COLUMN_WIDTH * column;
+            DrawText(TextFormat("%.3f", (double) milliseconds), column_x, line, HUD_FONT_SIZE, RAYWHITE);
+        }
+        line += HUD_LINE_HEIGHT;
+    }
+
+    const int32_t* counts = stats->command_counts;
+    DrawText(
+        TextFormat(
+            "%d rect  %d border  %d text",
+            counts[CLAY_RENDER_COMMAND_TYPE_RECTANGLE],
+            counts[CLAY_RENDER_COMMAND_TYPE_BORDER],
+            counts[CLAY_RENDER_COMMAND_TYPE_TEXT]
+        ),
+        left, line, HUD_FONT_SIZE, RAYWHITE
+    );
+    line += HUD_LINE_HEIGHT;
+    DrawText(
+        TextFormat(
+            "%d image  %d scissor  %d custom",
+            counts[CLAY_RENDER_COMMAND_TYPE_IMAGE],
+            counts[CLAY_RENDER_COMMAND_TYPE_SCISSOR_START],
+            counts[CLAY_RENDER_COMMAND_TYPE_CUSTOM]
+        ),
+        left, line, HUD_FONT_SIZE, RAYWHITE
+    );
+    line += HUD_LINE_HEIGHT;
+    DrawText(TextFormat("%d culled", stats->culled_commands), left, line, HUD_FONT_SIZE, RAYWHITE);
+    line += HUD_LINE_HEIGHT;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    for (int sample = 0; sample < stats->sample_count; ++sample) {
+        hits += stats->measure_hits[sample];
+        misses += stats->measure_misses[sample];
+    }
+    double hit_rate = hits + misses > 0 ? (double) hits * 100.0 / (double) (hits + misses) : 100.0;
+    DrawText(TextFormat("measure cache %.1f%% hits", hit_rate), left, line, HUD_FONT_SIZE, RAYWHITE);
+    line += HUD_LINE_HEIGHT;
+    DrawText(
+        TextFormat("%llu hits  %llu misses", (unsigned long long) hits, (unsigned long long) misses),
+        left, line, HUD_FONT_SIZE, RAYWHITE
+    );
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "clay.h"
+
+#include <stdint.h>
+
+
+// Frames the percentiles are taken over
+constexpr int FRAME_STATS_WINDOW = 240;
+
+typedef enum FramePhase {
+    // Clay_BeginLayout() until Clay_EndLayout(), declaring the elements
+    FRAME_PHASE_DECLARE,
+    // Clay_EndLayout(), which is sizing, positioning and generating commands
+    FRAME_PHASE_FINAL_LAYOUT,
+    // Time in the measure text function, part of the two phases above
+    FRAME_PHASE_MEASURE,
+    FRAME_PHASE_RENDER,
+    // EndDrawing(), the buffer swap plus whatever raylib waits for the target FPS
+    FRAME_PHASE_PRESENT,
+    FRAME_PHASE_COUNT,
+} FramePhase;
+
+// Where frame time goes, kept for the last FRAME_STATS_WINDOW presented frames.
+// Timing calls return right away while disabled, so they can stay in the frame loop.
+typedef struct FrameStats {
+    bool enabled;
+
+    // Nanoseconds, phases can be entered several times per frame and add up
+    uint64_t started[FRAME_PHASE_COUNT];
+    uint64_t elapsed[FRAME_PHASE_COUNT];
+
+    // Rolling window of milliseconds per phase
+    float samples[FRAME_PHASE_COUNT][FRAME_STATS_WINDOW];
+    uint64_t measure_hits[FRAME_STATS_WINDOW];
+    uint64_t measure_misses[FRAME_STATS_WINDOW];
+    int sample_count;
+    int next_sample;
+
+    // Of the last frame, by Clay_RenderCommandType
+    int32_t command_counts[CLAY_RENDER_COMMAND_TYPE_CUSTOM + 1];
+    // Of the last frame, commands the renderer culled as out of sight instead of drawing
+    int32_t culled_commands;
+    // Clay's totals when the frame started, to get the frame's share
+    Clay_MeasureTextCacheStats measure_cache;
+} FrameStats;
+
+
+uint64_t frame_stats_now(void);
+
+// Starts over with an empty window, so the HUD never mixes in stale frames
+void frame_stats_enable(FrameStats* stats, bool enabled);
+
+[[gnu::always_inline]]
+static inline void frame_stats_begin(FrameStats* stats, FramePhase phase) {
+    if (stats->enabled)
+        stats->started[phase] = frame_stats_now();
+}
+
+[[gnu::always_inline]]
+static inline void frame_stats_end(FrameStats* stats, FramePhase phase) {
+    if (stats->enabled)
+        stats->elapsed[phase] += frame_stats_now() - stats->started[phase];
+}
+
+void frame_stats_count_commands(FrameStats* stats, Clay_RenderCommandArray renderCommands);
+void frame_stats_count_culled(FrameStats* stats, int32_t culled);
+// Moves this frame's times into the window
+void frame_stats_end_frame(FrameStats* stats);
+
+// Milliseconds, `percentile` in [0, 1]
+float frame_stats_percentile(const FrameStats* stats, FramePhase phase, float percentile);
+
+// Draws the stats in a box with its top left corner at x, y, with raylib's default font
+void frame_stats_draw_hud(const FrameStats* stats, int x, int y);
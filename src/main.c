@@ -1,11 +1,19 @@
 #include "clay.h"
+#include "event_loop.h"
+#include "frame_stats.h"
+#include "renderer/capture.h"
 #include "renderer/clay_raylib.h"
+#include "renderer/clay_software.h"
+#include "renderer/fingerprint.h"
+#include "trace.h"
 
 #include <math.h>
 #include <raylib.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 
 constexpr int width = 600;
@@ -15,67 +23,814 @@ const char* title = "Clay Demo";
 constexpr Clay_Color CLAY_BLACK = { 0, 0, 0, 255 };
 constexpr Clay_Color CLAY_RED = { 255, 0, 0, 255 };
 
+// Don't redraw frames whose render commands match the last presented one
+constexpr bool skip_idle_frames = true;
+// How long a skipped frame sleeps before polling input again while animating
+constexpr double idle_frame_time = 1.0 / 60.0;
+// Clay decays scroll momentum per frame, keep producing frames for this long after scrolling
+constexpr double scroll_momentum_time = 2.0;
+
+// Toggles the frame timing HUD
+constexpr int hud_key = KEY_F3;
+
+// Writes the trace recorded so far, in builds with tracing
+constexpr int trace_flush_key = KEY_F4;
+const char* trace_path = "cchat.trace.json";
+
+// Pixel size fonts get rasterized at for the software renderer
+constexpr int headless_font_size = 32;
+
+// Floating root counts --bench-floating lays out, like popups, tooltips and toasts piling up
+constexpr int bench_floating_counts[] = { 10, 100, 1000 };
+// Distinct strings --bench-measure puts through Clay's text measurement cache
+constexpr int bench_measure_counts[] = { 1000, 10000, 100000 };
+
 
 typedef uint64_t u64;
 
+typedef struct FrameCounters {
+    u64 presented;
+    u64 skipped;
+} FrameCounters;
+
+// Off until the HUD is brought up, then every timing call in the loop records
+FrameStats frameStats = {};
+
 
 void HandleClayErrors(Clay_ErrorData errorData) {
     fputs(errorData.errorText.chars, stderr);
 }
 
-int main(void) {
-    Clay_Raylib_Initialize(width, height, title, FLAG_WINDOW_RESIZABLE);
-
+Clay_Context* InitializeClay(Clay_Dimensions dimensions) {
     // Clay Memory Initialization
     const u64 clayRequiredMemory = Clay_MinMemorySize();
     Clay_Arena clayArena = Clay_CreateArenaWithCapacityAndMemory(clayRequiredMemory, malloc(clayRequiredMemory));
 
-    [[maybe_unused]]
-    Clay_Context *context = Clay_Initialize(
+    Clay_Context* context = Clay_Initialize(
         clayArena,
-        (Clay_Dimensions) {
-            .width = (float) GetScreenWidth(),
-            .height = (float) GetScreenHeight()
-        },
+        dimensions,
         (Clay_ErrorHandler) { .errorHandlerFunction = HandleClayErrors }
     );
+    // Idle frames get their layout handed back, and messages that didn't change keep their sizes and lines
+    Clay_SetLayoutReuseEnabled(true);
+    return context;
+}
 
-    Clay_SetMeasureTextFunction(Raylib_MeasureText, nullptr);
+// Raylib_MeasureTextBatch with its time added to the HUD, only installed while the HUD is up
+Clay_Dimensions MeasureTextTimed(
+    Clay_StringSlice text,
+    Clay_MeasureTextWord* words,
+    int32_t wordCount,
+    Clay_TextElementConfig* config,
+    void* userData
+) {
+    frame_stats_begin(&frameStats, FRAME_PHASE_MEASURE);
+    Clay_Dimensions space = Raylib_MeasureTextBatch(text, words, wordCount, config, userData);
+    frame_stats_end(&frameStats, FRAME_PHASE_MEASURE);
+    return space;
+}
 
-    // Main loop
-    while (!WindowShouldClose()) {
-        // Build the Clay layout
-        Clay_BeginLayout();
+Clay_RenderCommandArray BuildLayout(void) {
+    frame_stats_begin(&frameStats, FRAME_PHASE_DECLARE);
+    TRACE_BEGIN("declare");
+    Clay_BeginLayout();
 
-        CLAY(
-            CLAY_ID("root"),
-            { .layout = {
-                .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) },
-                .padding = CLAY_PADDING_ALL(20),
+    CLAY(
+        CLAY_ID("root"),
+        { .layout = {
+            .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) },
+            .padding = CLAY_PADDING_ALL(20),
+            .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_CENTER },
+            .layoutDirection = CLAY_TOP_TO_BOTTOM,
+        }}
+    ) {
+        CLAY_TEXT(CLAY_STRING("CChat"), CLAY_TEXT_CONFIG({ .fontSize = 64, .letterSpacing = 1, .textColor = CLAY_BLACK }));
+        CLAY(CLAY_ID("inner"), {
+            .layout = {
+                .sizing = { .width = CLAY_SIZING_FIT(0), .height = CLAY_SIZING_FIT(0) },
                 .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_CENTER },
                 .layoutDirection = CLAY_TOP_TO_BOTTOM,
-            }}
-        ) {
-            CLAY_TEXT(CLAY_STRING("CChat"), CLAY_TEXT_CONFIG({ .fontSize = 64, .letterSpacing = 1, .textColor = CLAY_BLACK }));
-            CLAY(CLAY_ID("inner"), {
-                .layout = {
-                    .sizing = { .width = CLAY_SIZING_FIT(0), .height = CLAY_SIZING_FIT(0) },
-                    .childAlignment = { .x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_CENTER },
-                    .layoutDirection = CLAY_TOP_TO_BOTTOM,
-                },
-                .backgroundColor = CLAY_BLACK
-            }) {
-                CLAY_TEXT(CLAY_STRING("Sample text"), CLAY_TEXT_CONFIG({ .fontSize = 24, .letterSpacing = 10, .textColor = CLAY_RED }));
+            },
+            .backgroundColor = CLAY_BLACK
+        }) {
+            CLAY_TEXT(CLAY_STRING("Sample text"), CLAY_TEXT_CONFIG({ .fontSize = 24, .letterSpacing = 10, .textColor = CLAY_RED }));
+        }
+    }
+
+    TRACE_END();
+    frame_stats_end(&frameStats, FRAME_PHASE_DECLARE);
+
+    frame_stats_begin(&frameStats, FRAME_PHASE_FINAL_LAYOUT);
+    TRACE_BEGIN("final layout");
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+    TRACE_END();
+    frame_stats_end(&frameStats, FRAME_PHASE_FINAL_LAYOUT);
+
+    return renderCommands;
+}
+
+double Seconds(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+typedef struct Options {
+    // Record every presented frame's render commands here
+    const char* capturePath;
+    // Draw the frames of this capture instead of the app's layout
+    const char* replayPath;
+
+    // Headless only from here on
+    const char* outputPath;
+    const char* fontPath;
+    int frames;
+    int width;
+    int height;
+    // 0 for one per processor
+    int threads;
+    // Time every thread count from 1 up to the processor count instead
+    bool bench;
+    // Time Clay_EndLayout() with more and more floating elements instead
+    bool benchFloating;
+    // Time text measurement cache misses and hits with more and more strings instead
+    bool benchMeasure;
+} Options;
+
+// Stand ins for the pointers of a capture being replayed, indexed by handle id
+typedef struct ReplayHandles {
+    void** pointers;
+    CaptureHandleKind* kinds;
+    uint32_t capacity;
+} ReplayHandles;
+
+// Average raster time of a frame, over `frames` renders of the same commands
+double TimeRaster(Clay_Software_Renderer* renderer, Clay_RenderCommandArray renderCommands, int frames) {
+    double start = Seconds();
+    for (int frame = 0; frame < frames; ++frame)
+        Clay_Software_Render(renderer, renderCommands, WHITE);
+
+    return (Seconds() - start) / frames;
+}
+
+// Raster time for 1, 2, 4... threads up to the processor count, checking every count
+// draws exactly the pixels the single threaded pass does
+bool BenchThreads(Clay_Software_Renderer* renderer, Clay_RenderCommandArray renderCommands, int frames) {
+    int pixelWidth;
+    int pixelHeight;
+    const Color* pixels = Clay_Software_Pixels(renderer, &pixelWidth, &pixelHeight);
+    size_t frameBytes = sizeof(Color) * (size_t) pixelWidth * (size_t) pixelHeight;
+
+    Color* reference = (Color*) malloc(frameBytes);
+    if (reference == nullptr)
+        return false;
+
+    int processors = Clay_Software_SetThreadCount(renderer, 0);
+    double singleThreaded = 0;
+    bool identical = true;
+
+    for (int requested = 1;; requested = requested * 2 < processors ? requested * 2 : processors) {
+        int threads = Clay_Software_SetThreadCount(renderer, requested);
+        double frameTime = TimeRaster(renderer, renderCommands, frames);
+
+        bool matches = true;
+        if (threads == 1) {
+            singleThreaded = frameTime;
+            memcpy(reference, pixels, frameBytes);
+        } else {
+            matches = memcmp(reference, pixels, frameBytes) == 0;
+            identical = identical && matches;
+        }
+
+        printf(
+            "%3d threads: %8.3f ms/frame, %5.2fx%s\n",
+            threads,
+            frameTime * 1000.0,
+            singleThreaded / frameTime,
+            matches ? "" : ", OUTPUT DIFFERS"
+        );
+
+        // Also stops when no more threads can be spawned
+        if (threads >= processors || threads < requested)
+            break;
+    }
+
+    free(reference);
+    return identical;
+}
+
+// Average Clay_EndLayout() time over `frames` layouts of `count` floating elements, their
+// zIndex spread out and shuffled so the roots need sorting
+double TimeFloatingLayout(int count, int frames) {
+    double elapsed = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        Clay_BeginLayout();
+        CLAY(CLAY_ID("root"), { .layout = { .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) } } }) {
+            for (int idx = 0; idx < count; ++idx) {
+                CLAY_AUTO_ID({
+                    .layout = { .sizing = { .width = CLAY_SIZING_FIXED(16), .height = CLAY_SIZING_FIXED(16) } },
+                    .floating = {
+                        .attachTo = CLAY_ATTACH_TO_PARENT,
+                        .zIndex = (int16_t) (idx * 7919 % 64 - 32),
+                        .offset = { (float) (idx % 32 * 16), (float) (idx / 32 * 16) },
+                    },
+                    .backgroundColor = CLAY_RED,
+                }) {}
             }
         }
-        Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+
+        double start = Seconds();
+        Clay_EndLayout();
+        elapsed += Seconds() - start;
+    }
+
+    return elapsed / frames;
+}
+
+void BenchFloating(int frames) {
+    // Every frame is the same, reusing the layout would skip what's being timed
+    Clay_SetLayoutReuseEnabled(false);
+    for (size_t idx = 0; idx < sizeof(bench_floating_counts) / sizeof(bench_floating_counts[0]); ++idx) {
+        int count = bench_floating_counts[idx];
+        printf("%5d floating: %8.3f ms/layout\n", count, TimeFloatingLayout(count, frames) * 1000.0);
+    }
+    Clay_SetLayoutReuseEnabled(true);
+}
+
+// Clay's element ids collide now and then at 100k elements, which doesn't matter here
+void IgnoreClayErrors(Clay_ErrorData errorData) {
+    (void) errorData;
+}
+
+// Nanoseconds per text element declared, averaged over `frames` layouts of the same strings
+double TimeTextDeclarations(const Clay_String* strings, int count, int frames) {
+    double elapsed = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        Clay_BeginLayout();
+        double start = Seconds();
+        for (int group = 0; group < count; group += 100) {
+            CLAY_AUTO_ID({ .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
+                for (int idx = group; idx < count && idx < group + 100; ++idx)
+                    CLAY_TEXT(strings[idx], CLAY_TEXT_CONFIG({ .fontSize = 16, .textColor = CLAY_BLACK }));
+            }
+        }
+        elapsed += Seconds() - start;
+        Clay_EndLayout();
+    }
+
+    return elapsed * 1e9 / ((double) count * frames);
+}
+
+// Each count gets a Clay context of its own, sized to cache every string. The strings are
+// measured word by word, then again with the batch function, and found cached after that.
+bool BenchMeasure(Clay_Software_Renderer* renderer, int frames) {
+    Clay_Context* appContext = Clay_GetCurrentContext();
+    int32_t appElementCount = Clay_GetMaxElementCount();
+    int32_t appWordCount = Clay_GetMaxMeasureTextCacheWordCount();
+    bool succeeded = true;
+
+    for (size_t idx = 0; idx < sizeof(bench_measure_counts) / sizeof(bench_measure_counts[0]) && succeeded; ++idx) {
+        int count = bench_measure_counts[idx];
+        // Room for the strings, their containers and the root
+        Clay_SetMaxElementCount(count + count / 100 + 16);
+        Clay_SetMaxMeasureTextCacheWordCount(count * 8);
+
+        u64 memorySize = Clay_MinMemorySize();
+        void* memory = malloc(memorySize);
+        char* chars = (char*) malloc((size_t) count * 32);
+        Clay_String* strings = (Clay_String*) malloc(sizeof(Clay_String) * (size_t) count);
+        succeeded = memory != nullptr && chars != nullptr && strings != nullptr;
+
+        if (succeeded) {
+            for (int string = 0; string < count; ++string) {
+                char* text = chars + (size_t) string * 32;
+                int length = snprintf(text, 32, "message %d was sent", string);
+                strings[string] = (Clay_String) { .length = length, .chars = text };
+            }
+
+            Clay_Initialize(
+                Clay_CreateArenaWithCapacityAndMemory(memorySize, memory),
+                (Clay_Dimensions) { (float) width, (float) height },
+                (Clay_ErrorHandler) { .errorHandlerFunction = IgnoreClayErrors }
+            );
+            Clay_SetMeasureTextFunction(Clay_Software_MeasureText, renderer);
+            Clay_SetMeasureTextBatchFunction(nullptr, nullptr);
+            double wordTime = TimeTextDeclarations(strings, count, 1);
+
+            Clay_ResetMeasureTextCache();
+            Clay_SetMeasureTextBatchFunction(Clay_Software_MeasureTextBatch, renderer);
+            double batchTime = TimeTextDeclarations(strings, count, 1);
+
+            double hitTime = TimeTextDeclarations(strings, count, frames);
+            Clay_MeasureTextCacheStats cache = Clay_GetMeasureTextCacheStats();
+            printf(
+                "%6d strings: %7.1f ns/text by word, %7.1f ns/text batched, %7.1f ns/text cached (%llu hits, %llu misses)\n",
+                count,
+                wordTime,
+                batchTime,
+                hitTime,
+                (unsigned long long) cache.hits,
+                (unsigned long long) cache.misses
+            );
+        }
+
+        Clay_SetCurrentContext(appContext);
+        Clay_SetMaxElementCount(appElementCount);
+        Clay_SetMaxMeasureTextCacheWordCount(appWordCount);
+        free(memory);
+        free(chars);
+        free(strings);
+    }
+
+    return succeeded;
+}
+
+// Rasterizes every frame of a capture, following its layout dimensions. Handles all replay
+// as nullptr, the software renderer never looks behind them.
+bool ReplayHeadless(Clay_Software_Renderer* renderer, const char* replayPath, int threads) {
+    CaptureReader reader;
+    if (!capture_reader_open(&reader, replayPath, nullptr, nullptr)) {
+        fprintf(stderr, "Error: Could not read capture %s\n", replayPath);
+        return false;
+    }
+
+    threads = Clay_Software_SetThreadCount(renderer, threads);
+
+    u64 frames = 0;
+    double rasterTime = 0;
+    Clay_RenderCommandArray renderCommands;
+    Clay_Dimensions dimensions;
+    while (capture_read_frame(&reader, &renderCommands, &dimensions)) {
+        int frameWidth = (int) dimensions.width;
+        int frameHeight = (int) dimensions.height;
+        int pixelWidth;
+        int pixelHeight;
+        Clay_Software_Pixels(renderer, &pixelWidth, &pixelHeight);
+        if (
+            frameWidth > 0 && frameHeight > 0
+            && (frameWidth != pixelWidth || frameHeight != pixelHeight)
+            && !Clay_Software_Resize(renderer, frameWidth, frameHeight)
+        ) {
+            break;
+        }
+
+        double start = Seconds();
+        TRACE_BEGIN("raster");
+        Clay_Software_Render(renderer, renderCommands, WHITE);
+        TRACE_END();
+        rasterTime += Seconds() - start;
+        frames += 1;
+    }
+
+    printf(
+        "Replay: %llu frames on %d threads, %.3f ms raster per frame\n",
+        (unsigned long long) frames,
+        threads,
+        frames > 0 ? rasterTime * 1000.0 / (double) frames : 0.0
+    );
+
+    capture_reader_close(&reader);
+    return true;
+}
+
+// Lays out and rasterizes frames on the CPU, no window or GPU involved
+int RunHeadless(Options options) {
+    Clay_Software_Renderer* renderer = Clay_Software_Initialize(options.width, options.height);
+    if (renderer == nullptr) {
+        fprintf(stderr, "Error: Could not allocate a %dx%d framebuffer\n", options.width, options.height);
+        return 1;
+    }
+
+    if (options.fontPath != nullptr && Clay_Software_AddFont(renderer, options.fontPath, headless_font_size) == -1)
+        fprintf(stderr, "Warning: Could not load font %s, text won't be drawn\n", options.fontPath);
+
+    InitializeClay((Clay_Dimensions) { .width = (float) options.width, .height = (float) options.height });
+    Clay_SetMeasureTextFunction(Clay_Software_MeasureText, renderer);
+    Clay_SetMeasureTextBatchFunction(Clay_Software_MeasureTextBatch, renderer);
+
+    bool succeeded = true;
+    if (options.replayPath != nullptr) {
+        succeeded = ReplayHeadless(renderer, options.replayPath, options.threads);
+    } else if (options.benchFloating) {
+        BenchFloating(options.frames);
+    } else if (options.benchMeasure) {
+        succeeded = BenchMeasure(renderer, options.frames);
+        // The measure functions are shared by every context
+        Clay_SetMeasureTextFunction(Clay_Software_MeasureText, renderer);
+        Clay_SetMeasureTextBatchFunction(Clay_Software_MeasureTextBatch, renderer);
+    } else if (options.bench) {
+        Clay_RenderCommandArray renderCommands = BuildLayout();
+        succeeded = BenchThreads(renderer, renderCommands, options.frames);
+    } else {
+        int threads = Clay_Software_SetThreadCount(renderer, options.threads);
+
+        double layoutTime = 0;
+        double rasterTime = 0;
+        for (int frame = 0; frame < options.frames; ++frame) {
+            double start = Seconds();
+            Clay_RenderCommandArray renderCommands = BuildLayout();
+            double laidOut = Seconds();
+            TRACE_BEGIN("raster");
+            Clay_Software_Render(renderer, renderCommands, WHITE);
+            TRACE_END();
+            double rasterized = Seconds();
+
+            layoutTime += laidOut - start;
+            rasterTime += rasterized - laidOut;
+        }
+
+        printf(
+            "Headless: %d frames on %d threads, %.3f ms layout, %.3f ms raster per frame\n",
+            options.frames,
+            threads,
+            layoutTime * 1000.0 / options.frames,
+            rasterTime * 1000.0 / options.frames
+        );
+    }
+
+    if (options.outputPath != nullptr && !Clay_Software_SaveImage(renderer, options.outputPath)) {
+        fprintf(stderr, "Error: Could not write %s\n", options.outputPath);
+        succeeded = false;
+    }
+
+    Clay_Software_Close(renderer);
+    return succeeded ? 0 : 1;
+}
+
+// Placeholder checker textures for images and fresh layers for userData, so replays
+// exercise the image atlas and retained layers like the captured session did
+void* ResolveReplayHandle(void* context, CaptureHandleKind kind, uint32_t id) {
+    ReplayHandles* handles = (ReplayHandles*) context;
+
+    if (id >= handles->capacity) {
+        uint32_t capacity = handles->capacity == 0 ? 64 : handles->capacity;
+        while (capacity <= id) {
+            // Doubling past what a uint32_t or size_t holds would wrap to a small buffer
+            if (capacity > UINT32_MAX / 2 || (size_t) capacity * 2 > SIZE_MAX / sizeof(void*))
+                return nullptr;
+            capacity *= 2;
+        }
+
+        void** pointers = (void**) realloc(handles->pointers, sizeof(void*) * capacity);
+        if (pointers != nullptr)
+            handles->pointers = pointers;
+        CaptureHandleKind* kinds = (CaptureHandleKind*) realloc(handles->kinds, sizeof(CaptureHandleKind) * capacity);
+        if (kinds != nullptr)
+            handles->kinds = kinds;
+        if (pointers == nullptr || kinds == nullptr)
+            return nullptr;
+
+        for (uint32_t idx = handles->capacity; idx < capacity; ++idx)
+            handles->pointers[idx] = nullptr;
+        handles->capacity = capacity;
+    }
+
+    // The writer hands out ids per pointer, so one can show up as different kinds. Only the
+    // kind it first stood in for gets it, the stand-ins aren't interchangeable.
+    if (handles->pointers[id] != nullptr)
+        return handles->kinds[id] == kind ? handles->pointers[id] : nullptr;
+
+    void* pointer = nullptr;
+    switch (kind) {
+        case CAPTURE_HANDLE_IMAGE: {
+            Texture2D* texture = (Texture2D*) malloc(sizeof(Texture2D));
+            if (texture == nullptr)
+                break;
+
+            Image checker = GenImageChecked(64, 64, 8, 8, LIGHTGRAY, GRAY);
+            *texture = LoadTextureFromImage(checker);
+            UnloadImage(checker);
+            pointer = texture;
+            break;
+        }
+
+        case CAPTURE_HANDLE_USER_DATA: {
+            Clay_Raylib_Layer* layer = (Clay_Raylib_Layer*) malloc(sizeof(Clay_Raylib_Layer));
+            if (layer != nullptr)
+                *layer = (Clay_Raylib_Layer) { .tag = CLAY_RAYLIB_LAYER_TAG };
+            pointer = layer;
+            break;
+        }
+
+        // What custom data means is up to the app, there is nothing to stand in for it
+        case CAPTURE_HANDLE_CUSTOM:
+            break;
+    }
+
+    handles->pointers[id] = pointer;
+    handles->kinds[id] = kind;
+    return pointer;
+}
+
+void FreeReplayHandles(Clay_Raylib_Renderer* renderer, ReplayHandles* handles) {
+    for (uint32_t id = 0; id < handles->capacity; ++id) {
+        void* pointer = handles->pointers[id];
+        if (pointer == nullptr)
+            continue;
+
+        if (handles->kinds[id] == CAPTURE_HANDLE_IMAGE) {
+            Clay_Raylib_ForgetImage(renderer, *(Texture2D*) pointer);
+            UnloadTexture(*(Texture2D*) pointer);
+        } else if (handles->kinds[id] == CAPTURE_HANDLE_USER_DATA) {
+            Clay_Raylib_UnloadLayer((Clay_Raylib_Layer*) pointer);
+        }
+        free(pointer);
+    }
+
+    free(handles->pointers);
+    free(handles->kinds);
+    *handles = (ReplayHandles) {};
+}
+
+// Draws every frame of a capture as fast as it goes, resizing the window along with it
+int RunReplay(const char* replayPath) {
+    Clay_Raylib_Renderer* renderer = Clay_Raylib_Initialize(width, height, title, 0);
+    SetTargetFPS(0);
+
+    ReplayHandles handles = {};
+    CaptureReader reader;
+    if (!capture_reader_open(&reader, replayPath, ResolveReplayHandle, &handles)) {
+        fprintf(stderr, "Error: Could not read capture %s\n", replayPath);
+        Clay_Raylib_Close(renderer);
+        return 1;
+    }
+
+    u64 frames = 0;
+    double start = GetTime();
+    Clay_RenderCommandArray renderCommands;
+    Clay_Dimensions dimensions;
+    while (!WindowShouldClose() && capture_read_frame(&reader, &renderCommands, &dimensions)) {
+        int frameWidth = (int) dimensions.width;
+        int frameHeight = (int) dimensions.height;
+        if (frameWidth > 0 && frameHeight > 0 && (frameWidth != GetScreenWidth() || frameHeight != GetScreenHeight()))
+            SetWindowSize(frameWidth, frameHeight);
+
+        BeginDrawing();
+            ClearBackground(WHITE);
+            Clay_Raylib_Render(renderer, renderCommands);
+        EndDrawing();
+
+        frames += 1;
+    }
+    double elapsed = GetTime() - start;
+
+    printf(
+        "Replay: %llu frames, %.3f ms per frame\n",
+        (unsigned long long) frames,
+        frames > 0 ? elapsed * 1000.0 / (double) frames : 0.0
+    );
+
+    capture_reader_close(&reader);
+    FreeReplayHandles(renderer, &handles);
+    Clay_Raylib_Close(renderer);
+    return 0;
+}
+
+int RunWindowed(const char* capturePath) {
+    Clay_Raylib_Renderer* renderer = Clay_Raylib_Initialize(width, height, title, FLAG_WINDOW_RESIZABLE);
+
+    InitializeClay((Clay_Dimensions) {
+        .width = (float) GetScreenWidth(),
+        .height = (float) GetScreenHeight()
+    });
+
+    FontRegistry* fonts = Clay_Raylib_GetFonts(renderer);
+    CustomRegistry* customs = Clay_Raylib_GetCustomHandlers(renderer);
+    Clay_SetMeasureTextFunction(Raylib_MeasureText, fonts);
+    // Each string is measured in one call instead of one call per word
+    Clay_SetMeasureTextBatchFunction(Raylib_MeasureTextBatch, fonts);
+
+    EventLoop eventLoop;
+    if (!event_loop_init(&eventLoop)) {
+        fputs("Error: Could not set up the event loop", stderr);
+        Clay_Raylib_Close(renderer);
+        return 1;
+    }
+
+    SetTargetFPS(GetMonitorRefreshRate(GetCurrentMonitor()));
+
+    FrameCounters counters = {};
+    u64 presentedFingerprint = 0;
+
+    CaptureWriter capture = {};
+    if (capturePath != nullptr && !capture_writer_open(&capture, capturePath))
+        fprintf(stderr, "Warning: Could not create capture %s\n", capturePath);
+
+    // Main loop
+    while (!WindowShouldClose()) {
+        // Where wakeups from other threads come in
+        TRACE_BEGIN("ingest");
+        event_loop_poll(&eventLoop);
+        TRACE_END();
+
+        Clay_SetLayoutDimensions((Clay_Dimensions) {
+            .width = (float) GetScreenWidth(),
+            .height = (float) GetScreenHeight()
+        });
+
+        Vector2 mousePosition = GetMousePosition();
+        Vector2 wheel = GetMouseWheelMoveV();
+        bool pointerDown = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+
+        Clay_SetPointerState((Clay_Vector2) { mousePosition.x, mousePosition.y }, pointerDown);
+        // After a blocking wait the frame time spans the whole idle period
+        Clay_UpdateScrollContainers(
+            true,
+            (Clay_Vector2) { wheel.x, wheel.y },
+            fminf(GetFrameTime(), 0.1f)
+        );
+
+        if (pointerDown || fabsf(wheel.x) > 0 || fabsf(wheel.y) > 0)
+            event_loop_animate_for(&eventLoop, scroll_momentum_time);
+
+        if (IsKeyPressed(trace_flush_key))
+            TRACE_FLUSH();
+
+        if (IsKeyPressed(hud_key)) {
+            frame_stats_enable(&frameStats, !frameStats.enabled);
+            Clay_SetMeasureTextBatchFunction(frameStats.enabled ? MeasureTextTimed : Raylib_MeasureTextBatch, fonts);
+        }
+        // The HUD keeps changing, so it needs every frame drawn
+        if (frameStats.enabled)
+            event_loop_animate_for(&eventLoop, idle_frame_time);
+
+        Clay_RenderCommandArray renderCommands = BuildLayout();
+        frame_stats_count_commands(&frameStats, renderCommands);
+
+        u64 fingerprint = fingerprint_render_commands(renderCommands.internalArray, renderCommands.length);
+        bool unchanged = counters.presented > 0 && fingerprint == presentedFingerprint;
+
+        // A resize invalidates the back buffers even if the layout came out the same. Custom
+        // elements that animate only get to advance on frames that are drawn.
+        if (skip_idle_frames && unchanged && !IsWindowResized() && !frameStats.enabled && !customs->animating) {
+            // EndDrawing() normally polls input and paces the loop, do both by hand
+            counters.skipped += 1;
+            TRACE_BEGIN("idle");
+            event_loop_idle(&eventLoop, idle_frame_time);
+            TRACE_END();
+            continue;
+        }
+
+        if (capture.file != nullptr) {
+            Clay_Dimensions dimensions = { (float) GetScreenWidth(), (float) GetScreenHeight() };
+            if (!capture_write_frame(&capture, renderCommands, dimensions))
+                fputs("Warning: Could not write a captured frame\n", stderr);
+        }
 
         // Actual render
         BeginDrawing();
             ClearBackground(WHITE);
-            Clay_Raylib_Render(renderCommands);
+
+            frame_stats_begin(&frameStats, FRAME_PHASE_RENDER);
+            TRACE_BEGIN("render");
+            u64 culledBefore = Clay_Raylib_GetCullStats(renderer).culled;
+            Clay_Raylib_Render(renderer, renderCommands);
+            TRACE_END();
+            frame_stats_end(&frameStats, FRAME_PHASE_RENDER);
+            frame_stats_count_culled(&frameStats, (int32_t) (Clay_Raylib_GetCullStats(renderer).culled - culledBefore));
+
+            if (customs->animating)
+                event_loop_animate_for(&eventLoop, idle_frame_time);
+
+            if (frameStats.enabled)
+                frame_stats_draw_hud(&frameStats, 10, 10);
+
+            // Whatever this frame's input started animating is known by now
+            event_loop_pick_mode(&eventLoop);
+
+            frame_stats_begin(&frameStats, FRAME_PHASE_PRESENT);
+            TRACE_BEGIN("present");
         EndDrawing();
+        TRACE_END();
+        frame_stats_end(&frameStats, FRAME_PHASE_PRESENT);
+        frame_stats_end_frame(&frameStats);
+
+        counters.presented += 1;
+        presentedFingerprint = fingerprint;
+    }
+
+    printf(
+        "Frames: %llu presented, %llu skipped\n",
+        (unsigned long long) counters.presented,
+        (unsigned long long) counters.skipped
+    );
+    Clay_LayoutReuseStats layoutReuse = Clay_GetLayoutReuseStats();
+    printf(
+        "Layouts: %llu reused, %llu computed with %llu sizings and %llu text wraps reused\n",
+        (unsigned long long) layoutReuse.reused,
+        (unsigned long long) layoutReuse.computed,
+        (unsigned long long) layoutReuse.reusedSizings,
+        (unsigned long long) layoutReuse.reusedTextWraps
+    );
+    printf("Font atlases: %.1f KiB\n", (double) fonts->atlas_bytes / 1024.0);
+
+    TextRunCache* textRuns = Clay_Raylib_GetTextRuns(renderer);
+    printf(
+        "Text runs: %llu hits, %llu misses, %.1f KiB cached\n",
+        (unsigned long long) textRuns->hits,
+        (unsigned long long) textRuns->misses,
+        (double) textRuns->bytes / 1024.0
+    );
+
+    Clay_Raylib_CullStats cullStats = Clay_Raylib_GetCullStats(renderer);
+    printf(
+        "Commands: %llu drawn, %llu culled\n",
+        (unsigned long long) cullStats.drawn,
+        (unsigned long long) cullStats.culled
+    );
+
+    if (capture.file != nullptr) {
+        u64 frames = capture.frames;
+        double mebibytes = (double) capture.bytes / (1024.0 * 1024.0);
+        if (capture_writer_close(&capture))
+            printf("Capture: %llu frames, %.1f MiB\n", (unsigned long long) frames, mebibytes);
+        else
+            fprintf(stderr, "Error: Could not finish capture %s\n", capturePath);
     }
 
+    event_loop_close(&eventLoop);
+    Clay_Raylib_Close(renderer);
     return 0;
 }
+
+int main(int argc, char** argv) {
+    bool headless = false;
+    Options options = {
+        .frames = 1,
+        .width = width,
+        .height = height,
+        .threads = 1,
+    };
+
+    bool valid = true;
+    for (int idx = 1; idx < argc && valid; ++idx) {
+        const char* arg = argv[idx];
+        bool hasValue = idx + 1 < argc;
+
+        if (strcmp(arg, "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(arg, "--bench") == 0) {
+            headless = true;
+            options.bench = true;
+        } else if (strcmp(arg, "--bench-floating") == 0) {
+            headless = true;
+            options.benchFloating = true;
+        } else if (strcmp(arg, "--bench-measure") == 0) {
+            headless = true;
+            options.benchMeasure = true;
+        } else if (strcmp(arg, "--capture") == 0 && hasValue) {
+            options.capturePath = argv[++idx];
+        } else if (strcmp(arg, "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++idx];
+        } else if (strcmp(arg, "--output") == 0 && hasValue) {
+            options.outputPath = argv[++idx];
+        } else if (strcmp(arg, "--font") == 0 && hasValue) {
+            options.fontPath = argv[++idx];
+        } else if (strcmp(arg, "--frames") == 0 && hasValue) {
+            options.frames = atoi(argv[++idx]);
+        } else if (strcmp(arg, "--threads") == 0 && hasValue) {
+            options.threads = atoi(argv[++idx]);
+        } else if (strcmp(arg, "--size") == 0 && hasValue) {
+            valid = sscanf(argv[++idx], "%dx%d", &options.width, &options.height) == 2
+                && options.width > 0
+                && options.height > 0;
+        } else {
+            valid = false;
+        }
+    }
+
+    // Benchmarks run on the app's layout, captures are of the window
+    valid = valid
+        && !((options.bench || options.benchFloating || options.benchMeasure) && options.replayPath != nullptr)
+        && !(headless && options.capturePath != nullptr)
+        && !(options.replayPath != nullptr && options.capturePath != nullptr);
+
+    if (!valid) {
+        fprintf(
+            stderr,
+            "Usage: %s [--capture file | --replay file]\n"
+            "       %s --headless | --bench | --bench-floating | --bench-measure [--replay file] [--output image.png] [--font font.ttf]\n"
+            "       [--frames N] [--threads N, 0 for all processors] [--size WIDTHxHEIGHT]\n",
+            argv[0],
+            argv[0]
+        );
+        return 1;
+    }
+
+    if (!TRACE_INIT(trace_path))
+        fprintf(stderr, "Warning: Could not create trace %s\n", trace_path);
+    TRACE_THREAD_NAME("main");
+
+    int result;
+    if (!headless && options.replayPath != nullptr) {
+        result = RunReplay(options.replayPath);
+    } else if (!headless) {
+        result = RunWindowed(options.capturePath);
+    } else {
+        options.frames = options.frames > 0 ? options.frames : 1;
+        result = RunHeadless(options);
+    }
+
+    TRACE_SHUTDOWN();
+    return result;
+}
@@ -0,0 +1,402 @@
+#include "capture.h"
+
+#include "clay.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+static const char CAPTURE_MAGIC[4] = { 'C', 'C', 'A', 'P' };
+
+// Frames go out in a few large writes, a big stdio buffer turns those into fewer syscalls
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+constexpr uint32_t INITIAL_HANDLE_CAPACITY = 256;
+
+
+static uint32_t hash_pointer(const void* pointer) {
+    uint64_t bits = (uint64_t) (uintptr_t) pointer;
+    return (uint32_t) ((bits * 0x9E3779B97F4A7C15u) >> 32);
+}
+
+static bool grow_handles(CaptureWriter* writer) {
+    uint32_t capacity = writer->handle_capacity == 0 ? INITIAL_HANDLE_CAPACITY : writer->handle_capacity * 2;
+    const void** pointers = (const void**) calloc(capacity, sizeof(void*));
+    uint32_t* ids = (uint32_t*) calloc(capacity, sizeof(uint32_t));
+    if (pointers == nullptr || ids == nullptr) {
+        free(pointers);
+        free(ids);
+        return false;
+    }
+
+    uint32_t mask = capacity - 1;
+    for (uint32_t slot = 0; slot < writer->handle_capacity; ++slot) {
+        const void* pointer = writer->handle_pointers[slot];
+        if (pointer == nullptr)
+            continue;
+
+        uint32_t target = hash_pointer(pointer) & mask;
+        while (pointers[target] != nullptr)
+            target = (target + 1) & mask;
+
+        pointers[target] = pointer;
+        ids[target] = writer->handle_ids[slot];
+    }
+
+    free(writer->handle_pointers);
+    free(writer->handle_ids);
+    writer->handle_pointers = pointers;
+    writer->handle_ids = ids;
+    writer->handle_capacity = capacity;
+    return true;
+}
+
+// Id of `pointer`, handing out the next one the first time it shows up. 0 if out of memory.
+static uint32_t handle_id(CaptureWriter* writer, const void* pointer) {
+    if (pointer == nullptr)
+        return 0;
+
+    if ((writer->handle_count + 1) * 2 > writer->handle_capacity && !grow_handles(writer))
+        return 0;
+
+    uint32_t mask = writer->handle_capacity - 1;
+    uint32_t slot = hash_pointer(pointer) & mask;
+    while (writer->handle_pointers[slot] != nullptr) {
+        if (writer->handle_pointers[slot] == pointer)
+            return writer->handle_ids[slot];
+        slot = (slot + 1) & mask;
+    }
+
+    writer->handle_pointers[slot] = pointer;
+    writer->handle_ids[slot] = ++writer->handle_count;
+    return writer->handle_count;
+}
+
+static void store_color(float* destination, Clay_Color color) {
+    destination[0] = color.r;
+    destination[1] = color.g;
+    destination[2] = color.b;
+    destination[3] = color.a;
+}
+
+static Clay_Color load_color(const float* source) {
+    return (Clay_Color) { source[0], source[1], source[2], source[3] };
+}
+
+static void store_corners(float* destination, Clay_CornerRadius radius) {
+    destination[0] = radius.topLeft;
+    destination[1] = radius.topRight;
+    destination[2] = radius.bottomLeft;
+    destination[3] = radius.bottomRight;
+}
+
+static Clay_CornerRadius load_corners(const float* source) {
+    return (Clay_CornerRadius) { source[0], source[1], source[2], source[3] };
+}
+
+static bool grow_buffer(void** buffer, uint32_t* capacity, uint32_t needed, size_t element_size) {
+    if (needed <= *capacity)
+        return true;
+
+    uint32_t grown = *capacity * 2 > needed ? *capacity * 2 : needed;
+    void* resized = realloc(*buffer, element_size * grown);
+    if (resized == nullptr)
+        return false;
+
+    *buffer = resized;
+    *capacity = grown;
+    return true;
+}
+
+
+bool capture_writer_open(CaptureWriter* writer, const char* path) {
+    *writer = (CaptureWriter) { .file = fopen(path, "wb") };
+    if (writer->file == nullptr)
+        return false;
+
+    setvbuf(writer->file, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+
+    CaptureHeader header = { .version = CAPTURE_VERSION, .command_size = sizeof(CaptureCommand) };
+    memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        capture_writer_close(writer);
+        return false;
+    }
+
+    writer->bytes = sizeof(header);
+    return true;
+}
+
+bool capture_writer_close(CaptureWriter* writer) {
+    bool succeeded = writer->file != nullptr && !ferror(writer->file);
+    if (writer->file != nullptr)
+        succeeded = fclose(writer->file) == 0 && succeeded;
+
+    free(writer->records);
+    free(writer->strings);
+    free(writer->handle_pointers);
+    free(writer->handle_ids);
+    *writer = (CaptureWriter) {};
+    return succeeded;
+}
+
+bool capture_write_frame(CaptureWriter* writer, Clay_RenderCommandArray commands, Clay_Dimensions dimensions) {
+    if (!grow_buffer((void**) &writer->records, &writer->record_capacity, (uint32_t) commands.length, sizeof(CaptureCommand)))
+        return false;
+
+    uint32_t string_bytes = 0;
+    for (int32_t idx = 0; idx < commands.length; ++idx) {
+        const Clay_RenderCommand* command = Clay_RenderCommandArray_Get(&commands, idx);
+        const Clay_RenderData* data = &command->renderData;
+        CaptureCommand* record = &writer->records[idx];
+
+        // Records go to disk as they are, padding included, so the same frame always
+        // writes the same bytes
+        memset(record, 0, sizeof(*record));
+        record->x = command->boundingBox.x;
+        record->y = command->boundingBox.y;
+        record->width = command->boundingBox.width;
+        record->height = command->boundingBox.height;
+        record->id = command->id;
+        record->user_data = handle_id(writer, command->userData);
+        record->z_index = command->zIndex;
+        record->type = (uint8_t) command->commandType;
+
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+                store_color(record->color, data->rectangle.backgroundColor);
+                store_corners(record->corner_radius, data->rectangle.cornerRadius);
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                Clay_BorderWidth width = data->border.width;
+                store_color(record->color, data->border.color);
+                store_corners(record->corner_radius, data->border.cornerRadius);
+                record->border_width[0] = width.left;
+                record->border_width[1] = width.right;
+                record->border_width[2] = width.top;
+                record->border_width[3] = width.bottom;
+                record->border_width[4] = width.betweenChildren;
+                break;
+            }
+
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_StringSlice slice = data->text.stringContents;
+                uint32_t length = (uint32_t) slice.length;
+                if (!grow_buffer((void**) &writer->strings, &writer->string_capacity, string_bytes + length, 1))
+                    return false;
+
+                memcpy(writer->strings + string_bytes, slice.chars, length);
+                store_color(record->color, data->text.textColor);
+                record->data = string_bytes;
+                record->text_length = length;
+                record->font_id = data->text.fontId;
+                record->font_size = data->text.fontSize;
+                record->letter_spacing = data->text.letterSpacing;
+                record->line_height = data->text.lineHeight;
+                string_bytes += length;
+                break;
+            }
+
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+                store_color(record->color, data->image.backgroundColor);
+                store_corners(record->corner_radius, data->image.cornerRadius);
+                record->data = handle_id(writer, data->image.imageData);
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+                store_color(record->color, data->custom.backgroundColor);
+                store_corners(record->corner_radius, data->custom.cornerRadius);
+                record->data = handle_id(writer, data->custom.customData);
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+                record->clip_horizontal = data->clip.horizontal;
+                record->clip_vertical = data->clip.vertical;
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+            case CLAY_RENDER_COMMAND_TYPE_NONE:
+                break;
+        }
+    }
+
+    CaptureFrame frame = {
+        .command_count = (uint32_t) commands.length,
+        .string_bytes = string_bytes,
+        .width = dimensions.width,
+        .height = dimensions.height,
+    };
+
+    bool written = fwrite(&frame, sizeof(frame), 1, writer->file) == 1
+        && fwrite(writer->records, sizeof(CaptureCommand), frame.command_count, writer->file) == frame.command_count
+        && fwrite(writer->strings, 1, string_bytes, writer->file) == string_bytes;
+    if (!written)
+        return false;
+
+    writer->frames += 1;
+    writer->bytes += sizeof(frame) + sizeof(CaptureCommand) * frame.command_count + string_bytes;
+    return true;
+}
+
+
+bool capture_reader_open(CaptureReader* reader, const char* path, CaptureResolve resolve, void* context) {
+    *reader = (CaptureReader) { .file = fopen(path, "rb"), .resolve = resolve, .context = context };
+    if (reader->file == nullptr)
+        return false;
+
+    CaptureHeader header;
+    bool valid = fread(&header, sizeof(header), 1, reader->file) == 1
+        && memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == CAPTURE_VERSION
+        && header.command_size == sizeof(CaptureCommand);
+    if (!valid) {
+        capture_reader_close(reader);
+        return false;
+    }
+
+    return true;
+}
+
+void capture_reader_close(CaptureReader* reader) {
+    if (reader->file != nullptr)
+        fclose(reader->file);
+
+    free(reader->records);
+    free(reader->commands);
+    free(reader->strings);
+    *reader = (CaptureReader) {};
+}
+
+static void* resolve(CaptureReader* reader, CaptureHandleKind kind, uint32_t id) {
+    if (id == 0 || reader->resolve == nullptr || id > reader->records_read * 2)
+        return nullptr;
+
+    return reader->resolve(reader->context, kind, id);
+}
+
+bool capture_read_frame(CaptureReader* reader, Clay_RenderCommandArray* commands, Clay_Dimensions* dimensions) {
+    CaptureFrame frame;
+    if (fread(&frame, sizeof(frame), 1, reader->file) != 1 || frame.command_count > INT32_MAX)
+        return false;
+
+    bool allocated =
+        grow_buffer((void**) &reader->records, &reader->record_capacity, frame.command_count, sizeof(CaptureCommand))
+        && grow_buffer((void**) &reader->commands, &reader->command_capacity, frame.command_count, sizeof(Clay_RenderCommand))
+        && grow_buffer((void**) &reader->strings, &reader->string_capacity, frame.string_bytes, 1);
+    if (!allocated)
+        return false;
+
+    bool complete = fread(reader->records, sizeof(CaptureCommand), frame.command_count, reader->file) == frame.command_count
+        && fread(reader->strings, 1, frame.string_bytes, reader->file) == frame.string_bytes;
+    if (!complete)
+        return false;
+    reader->records_read += frame.command_count;
+
+    // Records no backend can draw are left out, so every command handed back is a known type
+    // and every image has its data
+    int32_t count = 0;
+    for (uint32_t idx = 0; idx < frame.command_count; ++idx) {
+        const CaptureCommand* record = &reader->records[idx];
+        Clay_RenderCommand* command = &reader->commands[count];
+
+        *command = (Clay_RenderCommand) {
+            .boundingBox = { record->x, record->y, record->width, record->height },
+            .userData = resolve(reader, CAPTURE_HANDLE_USER_DATA, record->user_data),
+            .id = record->id,
+            .zIndex = record->z_index,
+            .commandType = (Clay_RenderCommandType) record->type,
+        };
+
+        Clay_RenderData* data = &command->renderData;
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+                data->rectangle = (Clay_RectangleRenderData) {
+                    .backgroundColor = load_color(record->color),
+                    .cornerRadius = load_corners(record->corner_radius),
+                };
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+                data->border = (Clay_BorderRenderData) {
+                    .color = load_color(record->color),
+                    .cornerRadius = load_corners(record->corner_radius),
+                    .width = {
+                        .left = record->border_width[0],
+                        .right = record->border_width[1],
+                        .top = record->border_width[2],
+                        .bottom = record->border_width[3],
+                        .betweenChildren = record->border_width[4],
+                    },
+                };
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                // A damaged capture must not send text off the end of the frame's bytes
+                bool in_bounds = record->data <= frame.string_bytes
+                    && record->text_length <= frame.string_bytes - record->data;
+                const char* chars = reader->strings + (in_bounds ? record->data : 0);
+                int32_t length = in_bounds ? (int32_t) record->text_length : 0;
+
+                data->text = (Clay_TextRenderData) {
+                    .stringContents = { .length = length, .chars = chars, .baseChars = chars },
+                    .textColor = load_color(record->color),
+                    .fontId = record->font_id,
+                    .fontSize = record->font_size,
+                    .letterSpacing = record->letter_spacing,
+                    .lineHeight = record->line_height,
+                };
+                break;
+            }
+
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                // Backends dereference imageData, an image that didn't resolve has nothing to draw
+                void* image = resolve(reader, CAPTURE_HANDLE_IMAGE, record->data);
+                if (image == nullptr)
+                    continue;
+
+                data->image = (Clay_ImageRenderData) {
+                    .backgroundColor = load_color(record->color),
+                    .cornerRadius = load_corners(record->corner_radius),
+                    .imageData = image,
+                };
+                break;
+            }
+
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+                data->custom = (Clay_CustomRenderData) {
+                    .backgroundColor = load_color(record->color),
+                    .cornerRadius = load_corners(record->corner_radius),
+                    .customData = resolve(reader, CAPTURE_HANDLE_CUSTOM, record->data),
+                };
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+                data->clip = (Clay_ClipRenderData) {
+                    .horizontal = record->clip_horizontal,
+                    .vertical = record->clip_vertical,
+                };
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+                break;
+
+            // Types from a newer Clay are dropped
+            case CLAY_RENDER_COMMAND_TYPE_NONE:
+            default:
+                continue;
+        }
+
+        count += 1;
+    }
+
+    *commands = (Clay_RenderCommandArray) {
+        .capacity = (int32_t) frame.command_count,
+        .length = count,
+        .internalArray = reader->commands,
+    };
+    *dimensions = (Clay_Dimensions) { frame.width, frame.height };
+    return true;
+}
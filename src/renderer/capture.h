@@ -0,0 +1,126 @@
+#pragma once
+
+#include "clay.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+
+// Render command captures, so rendering problems can be reproduced and benchmarked without
+// the app around them.
+//
+// A file is a CaptureHeader followed by frames. A frame is a CaptureFrame, its commands as
+// CaptureCommand records and then the bytes of every text in it. Everything is written in
+// host byte order and layout, captures are meant to be replayed on the machine type that
+// made them. Pointers can't be stored, so images, custom data and userData are stored as
+// handle ids that stay the same for the same pointer over the whole capture.
+
+constexpr uint32_t CAPTURE_VERSION = 1;
+
+typedef struct CaptureHeader {
+    // "CCAP"
+    char magic[4];
+    uint32_t version;
+    // Catches captures from a build with a different record layout
+    uint32_t command_size;
+} CaptureHeader;
+
+typedef struct CaptureFrame {
+    uint32_t command_count;
+    uint32_t string_bytes;
+    // Layout dimensions the frame was laid out for
+    float width;
+    float height;
+} CaptureFrame;
+
+// Handle id 0 stands for nullptr
+typedef struct CaptureCommand {
+    float x, y, width, height;
+    // Background, text or border color
+    float color[4];
+    // Top left, top right, bottom left, bottom right like Clay_CornerRadius
+    float corner_radius[4];
+
+    uint32_t id;
+    uint32_t user_data;
+    // Image or custom data handle, or where the text starts in the frame's string bytes
+    uint32_t data;
+    uint32_t text_length;
+
+    // Left, right, top, bottom, between children
+    uint16_t border_width[5];
+    uint16_t font_id;
+    uint16_t font_size;
+    uint16_t letter_spacing;
+    uint16_t line_height;
+    int16_t z_index;
+
+    uint8_t type;
+    // Clip directions of a scissor start
+    bool clip_horizontal;
+    bool clip_vertical;
+} CaptureCommand;
+
+typedef enum CaptureHandleKind {
+    CAPTURE_HANDLE_IMAGE,
+    CAPTURE_HANDLE_CUSTOM,
+    CAPTURE_HANDLE_USER_DATA,
+} CaptureHandleKind;
+
+// Turns a handle id back into a pointer for replay, called with ids other than 0 only.
+// Ids come from one space shared by every kind, counting up from 1, and are never more
+// than twice the commands read so far.
+typedef void* (*CaptureResolve)(void* context, CaptureHandleKind kind, uint32_t id);
+
+typedef struct CaptureWriter {
+    FILE* file;
+    uint64_t frames;
+    uint64_t bytes;
+
+    CaptureCommand* records;
+    uint32_t record_capacity;
+    char* strings;
+    uint32_t string_capacity;
+
+    // Pointer -> handle id, open addressing with linear probing
+    const void** handle_pointers;
+    uint32_t* handle_ids;
+    // Power of two, kept at most half full
+    uint32_t handle_capacity;
+    uint32_t handle_count;
+} CaptureWriter;
+
+typedef struct CaptureReader {
+    FILE* file;
+    CaptureResolve resolve;
+    void* context;
+
+    CaptureCommand* records;
+    uint32_t record_capacity;
+    Clay_RenderCommand* commands;
+    uint32_t command_capacity;
+    char* strings;
+    uint32_t string_capacity;
+
+    // Every record brings at most two new handle ids, larger ones can only come from
+    // a damaged capture
+    uint64_t records_read;
+} CaptureReader;
+
+
+bool capture_writer_open(CaptureWriter* writer, const char* path);
+// Flushes and closes the file, false if anything failed to write
+bool capture_writer_close(CaptureWriter* writer);
+
+// Appends a frame. `dimensions` are the layout dimensions it was laid out for.
+bool capture_write_frame(CaptureWriter* writer, Clay_RenderCommandArray commands, Clay_Dimensions dimensions);
+
+
+// `resolve` can be nullptr, then every handle replays as nullptr. Image commands whose handle
+// replays as nullptr are dropped.
+bool capture_reader_open(CaptureReader* reader, const char* path, CaptureResolve resolve, void* context);
+void capture_reader_close(CaptureReader* reader);
+
+// Reads the next frame into `commands`, which stays valid until the next call.
+// False at the end of the capture or if it's cut short.
+bool capture_read_frame(CaptureReader* reader, Clay_RenderCommandArray* commands, Clay_Dimensions* dimensions);
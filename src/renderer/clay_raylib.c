@@ -1,7 +1,19 @@
 #include "clay_raylib.h"
 
+#include "../trace.h"
 #include "clay.h"
+#include "corner_cache.h"
+#include "custom_registry.h"
+#include "draw_list.h"
+#include "fingerprint.h"
+#include "font_metrics.h"
+#include "font_registry.h"
+#include "image_atlas.h"
 #include "raylib.h"
+#include "rect_batch.h"
+#include "render_batch.h"
+#include "rlgl.h"
+#include "text_run_cache.h"
 
 #include <math.h>
 #include <stddef.h>
@@ -10,8 +22,55 @@
 #include <string.h>
 
 
-static char* temp_render_buffer = nullptr;
-static size_t temp_render_buffer_len = 0;
+// Clipping elements nested deeper than this clip to the innermost one that fits
+constexpr int MAX_CLIP_DEPTH = 32;
+
+// Ways commands get drawn, the pipeline part of a draw key
+typedef enum DrawPipeline {
+    DRAW_PIPELINE_GEOMETRY = 1,
+    DRAW_PIPELINE_SDF,
+    DRAW_PIPELINE_INSTANCED,
+} DrawPipeline;
+
+
+struct Clay_Raylib_Renderer {
+    // Geometry for the frame, submitted once per texture or scissor change
+    RenderBatch batch;
+    // Tessellated rounded corners, reused across elements and frames
+    CornerCache corners;
+    // Rectangles and borders as shaded instances instead of tessellated geometry
+    RectBatch rects;
+    bool instanced_rects;
+    // Small images packed together so they batch instead of binding a texture each
+    ImageAtlas images;
+    FontRegistry fonts;
+    // Glyph layout of text drawn in recent frames
+    TextRunCache text_runs;
+    CustomRegistry customs;
+    // Turns distance field atlases back into coverage, see SDF_FRAGMENT_SHADER
+    Shader sdf_shader;
+    Clay_Raylib_CullStats cull_stats;
+    // The frame's commands in the order they're drawn, see compile_draw_list()
+    DrawList draws;
+    bool sort_draws;
+};
+
+
+// The edge sits at 0.5 and is antialiased over one screen pixel whatever the scale,
+// derivatives track how fast the distance changes per fragment
+static const char* SDF_FRAGMENT_SHADER =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    float distance = texture(texture0, fragTexCoord).a - 0.5;\n"
+    "    float change = length(vec2(dFdx(distance), dFdy(distance)));\n"
+    "    float alpha = smoothstep(-change, change, distance);\n"
+    "    finalColor = vec4(fragColor.rgb, fragColor.a * alpha) * colDiffuse;\n"
+    "}\n";
 
 
 [[gnu::always_inline]]
@@ -34,6 +93,22 @@ static inline Rectangle clay_bbox_to_raylib_rectangle(Clay_BoundingBox box) {
     };
 }
 
+[[gnu::always_inline]]
+static inline bool overlaps(Clay_BoundingBox box, Rectangle clip) {
+    return box.x < clip.x + clip.width
+        && box.y < clip.y + clip.height
+        && box.x + box.width > clip.x
+        && box.y + box.height > clip.y;
+}
+
+static Rectangle intersect(Rectangle a, Rectangle b) {
+    float left = fmaxf(a.x, b.x);
+    float top = fmaxf(a.y, b.y);
+    float right = fminf(a.x + a.width, b.x + b.width);
+    float bottom = fminf(a.y + a.height, b.y + b.height);
+    return (Rectangle) { left, top, fmaxf(right - left, 0), fmaxf(bottom - top, 0) };
+}
+
 [[gnu::always_inline]]
 static inline bool equal(float a, float b) {
     constexpr float EPSILON = 1e-9f;
@@ -44,279 +119,753 @@ static inline bool equal(float a, float b) {
 Clay_Dimensions Raylib_MeasureText(
     Clay_StringSlice text,
     Clay_TextElementConfig *cfg,
-    [[maybe_unused]] void *userData
+    void *userData
 ) {
-    // Measure string size for Font
-    Clay_Dimensions textSize = { 0 };
+    TRACE_BEGIN("measure");
+
+    FontRegistry* fonts = (FontRegistry*) userData;
+    const FontMetrics* metrics = font_registry_get(fonts, cfg->fontId, cfg->fontSize);
 
+    float scaleFactor = cfg->fontSize / (float) metrics->font.baseSize;
     float maxTextWidth = 0.0f;
-    float lineTextWidth = 0.0f;
-    int maxLineCharCount = 0;
-    int lineCharCount = 0;
 
-    float textHeight = cfg->fontSize;
+    // Clay measures word by word, so this is almost always a single line
+    const char* line = text.chars;
+    const char* end = text.chars + text.length;
+    while (text.length > 0) {
+        const char* newline = memchr(line, '\n', (size_t) (end - line));
+        const char* lineEnd = newline != nullptr ? newline : end;
+
+        int32_t lineCharCount;
+        float lineTextWidth = font_metrics_line_width(metrics, line, (int32_t) (lineEnd - line), &lineCharCount)
+            * scaleFactor;
+        lineTextWidth += (float) (lineCharCount * cfg->letterSpacing);
+        maxTextWidth = fmaxf(maxTextWidth, lineTextWidth);
+
+        if (newline == nullptr)
+            break;
+        line = newline + 1;
+    }
 
-    // Use Raylib default font
-    Font fontToUse = GetFontDefault();
+    TRACE_END();
+    return (Clay_Dimensions) {
+        .width = maxTextWidth,
+        .height = cfg->fontSize,
+    };
+}
 
-    float scaleFactor = cfg->fontSize / (float) fontToUse.baseSize;
+Clay_Dimensions Raylib_MeasureTextBatch(
+    Clay_StringSlice text,
+    Clay_MeasureTextWord *words,
+    int32_t wordCount,
+    Clay_TextElementConfig *cfg,
+    void *userData
+) {
+    TRACE_BEGIN("measure");
 
-    for (int idx = 0; idx < text.length; ++idx, ++lineCharCount) {
-        if (text.chars[idx] == '\n') {
-            maxTextWidth = fmaxf(maxTextWidth, lineTextWidth);
-            maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
+    FontRegistry* fonts = (FontRegistry*) userData;
+    const FontMetrics* metrics = font_registry_get(fonts, cfg->fontId, cfg->fontSize);
 
-            lineTextWidth = 0;
-            lineCharCount = 0;
-            continue;
-        }
+    float scaleFactor = cfg->fontSize / (float) metrics->font.baseSize;
+    font_metrics_measure_words(metrics, text.chars, words, wordCount, scaleFactor, cfg->letterSpacing);
 
-        int jdx = text.chars[idx] - 32;
-        if (fontToUse.glyphs[jdx].advanceX != 0)
-            lineTextWidth += (float) fontToUse.glyphs[jdx].advanceX;
-        else
-            lineTextWidth += (fontToUse.recs[jdx].width + (float) fontToUse.glyphs[jdx].offsetX);
+    TRACE_END();
+    return (Clay_Dimensions) {
+        .width = metrics->ascii_advance[' '] * scaleFactor + (float) cfg->letterSpacing,
+        .height = cfg->fontSize,
+    };
+}
+
+
+Clay_Raylib_Renderer* Clay_Raylib_Initialize(int width, int height, const char *title, unsigned int flags) {
+    SetConfigFlags(flags);
+    InitWindow(width, height, title);
+
+    Clay_Raylib_Renderer* renderer = (Clay_Raylib_Renderer*) calloc(1, sizeof(Clay_Raylib_Renderer));
+    if (
+        renderer == nullptr
+        || !font_registry_init(&renderer->fonts)
+        || !render_batch_init(&renderer->batch)
+        || !corner_cache_init(&renderer->corners)
+        || !image_atlas_init(&renderer->images)
+        || !text_run_cache_init(&renderer->text_runs)
+    ) {
+        fputs("Error: Could not allocate the renderer", stderr);
+        exit(1);
     }
 
-    maxTextWidth = fmaxf(maxTextWidth, lineTextWidth);
-    maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
+    custom_registry_init(&renderer->customs);
 
-    textSize.width = maxTextWidth * scaleFactor + (float) (lineCharCount * cfg->letterSpacing);
-    textSize.height = textHeight;
+    // raylib falls back to its default shader if this doesn't compile, SDF text then
+    // shows up blurry but everything else is unaffected
+    renderer->sdf_shader = LoadShaderFromMemory(nullptr, SDF_FRAGMENT_SHADER);
 
-    return textSize;
+    // Without instancing rectangles are tessellated, which looks the same minus antialiasing
+    renderer->instanced_rects = rect_batch_init(&renderer->rects);
+    renderer->sort_draws = true;
+
+    return renderer;
 }
 
+void Clay_Raylib_Close(Clay_Raylib_Renderer* renderer) {
+    font_registry_free(&renderer->fonts);
+    render_batch_free(&renderer->batch);
+    corner_cache_free(&renderer->corners);
+    rect_batch_free(&renderer->rects);
+    image_atlas_free(&renderer->images);
+    custom_registry_free(&renderer->customs);
+    text_run_cache_free(&renderer->text_runs);
+    draw_list_free(&renderer->draws);
+    UnloadShader(renderer->sdf_shader);
+    free(renderer);
 
-void Clay_Raylib_Initialize(int width, int height, const char *title, unsigned int flags) {
-    SetConfigFlags(flags);
-    InitWindow(width, height, title);
+    CloseWindow();
 }
 
-void Clay_Raylib_Close() {
-    free(temp_render_buffer);
-    temp_render_buffer_len = 0;
+bool Clay_Raylib_UseInstancedRects(Clay_Raylib_Renderer* renderer, bool enabled) {
+    renderer->instanced_rects = enabled && renderer->rects.shader_id != 0;
+    return renderer->instanced_rects;
+}
 
-    CloseWindow();
+void Clay_Raylib_SortDraws(Clay_Raylib_Renderer* renderer, bool enabled) {
+    renderer->sort_draws = enabled;
 }
 
+void Clay_Raylib_ForgetImage(Clay_Raylib_Renderer* renderer, Texture2D texture) {
+    image_atlas_forget(&renderer->images, texture.id);
+}
+
+FontRegistry* Clay_Raylib_GetFonts(Clay_Raylib_Renderer* renderer) {
+    return &renderer->fonts;
+}
 
-static void clay_render_text(Clay_BoundingBox boundingBox, Clay_TextRenderData* textData) {
-    size_t sstrlen = (size_t) textData->stringContents.length + 1;
+TextRunCache* Clay_Raylib_GetTextRuns(Clay_Raylib_Renderer* renderer) {
+    return &renderer->text_runs;
+}
+
+CustomRegistry* Clay_Raylib_GetCustomHandlers(Clay_Raylib_Renderer* renderer) {
+    return &renderer->customs;
+}
 
-    // Grow the temp buffer
-    if (sstrlen > temp_render_buffer_len) {
-        free(temp_render_buffer);
-        temp_render_buffer = (char *) malloc(sstrlen);
-        temp_render_buffer_len = sstrlen;
+Clay_Raylib_CullStats Clay_Raylib_GetCullStats(Clay_Raylib_Renderer* renderer) {
+    return renderer->cull_stats;
+}
+
+
+// Emits the run's glyph quads straight into the batch, offset to `position`
+static void push_text_run(RenderBatch* batch, const TextRun* run, Vector2 position, Color tint) {
+    for (int32_t qdx = 0; qdx < run->quad_count; ++qdx) {
+        const TextRunQuad* quad = &run->quads[qdx];
+        Rectangle dst = quad->dst;
+        dst.x += position.x;
+        dst.y += position.y;
+        render_batch_push_quad(batch, run->texture_id, dst, quad->uv, tint);
     }
+}
+
+static void clay_render_text(
+    Clay_Raylib_Renderer* renderer,
+    Clay_BoundingBox boundingBox,
+    Clay_TextRenderData* textData,
+    Color color
+) {
+    const FontMetrics* metrics = font_registry_get(&renderer->fonts, textData->fontId, textData->fontSize);
+    const TextRun* run = text_run_cache_get(&renderer->text_runs, metrics, textData);
+    if (run == nullptr)
+        return;
 
-    // Raylib uses C-Strings, need to clone string and append null terminator
-    memcpy(temp_render_buffer, textData->stringContents.chars, sstrlen - 1);
-    temp_render_buffer[textData->stringContents.length] = '\0';
-
-    DrawTextEx(
-        GetFontDefault(),
-        temp_render_buffer,
-        (Vector2) { boundingBox.x, boundingBox.y },
-        (float) textData->fontSize,
-        (float) textData->letterSpacing,
-        clay_color_to_raylib_color(textData->textColor)
+    if (metrics->sdf)
+        render_batch_set_shader(&renderer->batch, renderer->sdf_shader);
+
+    push_text_run(&renderer->batch, run, (Vector2) { boundingBox.x, boundingBox.y }, color);
+
+    // Only flushes once something else actually gets drawn
+    if (metrics->sdf)
+        render_batch_set_shader(&renderer->batch, render_batch_default_shader());
+}
+
+// Rotates a corner mesh point clockwise on screen, from the bottom right corner to the others
+[[gnu::always_inline]]
+static inline Vector2 quarter_turn(Vector2 point, int turns) {
+    switch (turns & 3) {
+        case 1: return (Vector2) { -point.y, point.x };
+        case 2: return (Vector2) { -point.x, -point.y };
+        case 3: return (Vector2) { point.y, -point.x };
+        default: return point;
+    }
+}
+
+// Fan-triangulates the rounded outline. Corners go in screen-clockwise angle order
+// (bottom right, bottom left, top left, top right) and triangles are emitted
+// reversed to keep raylib's counter-clockwise front faces.
+static void push_rounded_rect(
+    RenderBatch* batch,
+    CornerCache* corners,
+    Rectangle rect,
+    Clay_CornerRadius radii,
+    Color color
+) {
+    float max_radius = fminf(rect.width, rect.height) / 2;
+    float radius[4] = {
+        fminf(radii.bottomRight, max_radius),
+        fminf(radii.bottomLeft, max_radius),
+        fminf(radii.topLeft, max_radius),
+        fminf(radii.topRight, max_radius),
+    };
+    Vector2 corner[4] = {
+        { rect.x + rect.width - radius[0], rect.y + rect.height - radius[0] },
+        { rect.x + radius[1], rect.y + rect.height - radius[1] },
+        { rect.x + radius[2], rect.y + radius[2] },
+        { rect.x + rect.width - radius[3], rect.y + radius[3] },
+    };
+
+    // Square corners are a single point, the corner itself
+    static const Vector2 square_corner = {};
+    // All four meshes are held at once, none of the fetches may start the cache over
+    corner_cache_reserve(corners, 4);
+    CornerMesh mesh[4];
+    int outline_count = 0;
+    for (int cdx = 0; cdx < 4; ++cdx) {
+        mesh[cdx] = radius[cdx] > 0
+            ? corner_cache_get(corners, radius[cdx], 0)
+            : (CornerMesh) { .segments = 0, .outer = &square_corner };
+        outline_count += mesh[cdx].segments + 1;
+    }
+
+    RenderBatchSpan span = render_batch_reserve(
+        batch,
+        batch->solid_texture_id,
+        outline_count + 1,
+        outline_count * 3
     );
+
+    RenderVertex* vertex = span.vertices;
+    *vertex++ = (RenderVertex) {
+        rect.x + rect.width / 2,
+        rect.y + rect.height / 2,
+        batch->solid_u,
+        batch->solid_v,
+        color,
+    };
+
+    for (int cdx = 0; cdx < 4; ++cdx) {
+        for (int sdx = 0; sdx <= mesh[cdx].segments; ++sdx) {
+            Vector2 offset = quarter_turn(mesh[cdx].outer[sdx], cdx);
+            *vertex++ = (RenderVertex) {
+                corner[cdx].x + offset.x,
+                corner[cdx].y + offset.y,
+                batch->solid_u,
+                batch->solid_v,
+                color,
+            };
+        }
+    }
+
+    uint16_t* index = span.indices;
+    for (int idx = 0; idx < outline_count; ++idx) {
+        int next = (idx + 1) % outline_count;
+        *index++ = span.base;
+        *index++ = (uint16_t) (span.base + 1 + next);
+        *index++ = (uint16_t) (span.base + 1 + idx);
+    }
 }
 
-static void clay_render_rectangle(Clay_BoundingBox boundingbox, Clay_RectangleRenderData* rectangleData) {
-    if (rectangleData->cornerRadius.topLeft > 0) {
-        float radius = (rectangleData->cornerRadius.topLeft * 2) / fminf(boundingbox.width, boundingbox.height);
-        DrawRectangleRounded(
-            clay_bbox_to_raylib_rectangle(boundingbox),
-            radius,
-            0,
-            clay_color_to_raylib_color(rectangleData->backgroundColor)
-        );
-    } else {
-        DrawRectangle(
-            (int) boundingbox.x,
-            (int) boundingbox.y,
-            (int) boundingbox.width,
-            (int) boundingbox.height,
-            clay_color_to_raylib_color(rectangleData->backgroundColor)
-        );
+// Quarter annulus around `center`, starting `quarter_turns` clockwise from the bottom right
+static void push_corner_ring(
+    RenderBatch* batch,
+    CornerCache* corners,
+    Vector2 center,
+    float radius,
+    float width,
+    int quarter_turns,
+    Color color
+) {
+    corner_cache_reserve(corners, 1);
+    CornerMesh mesh = corner_cache_get(corners, radius, width);
+    RenderBatchSpan span = render_batch_reserve(
+        batch,
+        batch->solid_texture_id,
+        (mesh.segments + 1) * 2,
+        mesh.segments * 6
+    );
+
+    for (int sdx = 0; sdx <= mesh.segments; ++sdx) {
+        Vector2 outer = quarter_turn(mesh.outer[sdx], quarter_turns);
+        Vector2 inner = quarter_turn(mesh.inner[sdx], quarter_turns);
+
+        span.vertices[sdx * 2] = (RenderVertex) {
+            center.x + outer.x,
+            center.y + outer.y,
+            batch->solid_u,
+            batch->solid_v,
+            color,
+        };
+        span.vertices[sdx * 2 + 1] = (RenderVertex) {
+            center.x + inner.x,
+            center.y + inner.y,
+            batch->solid_u,
+            batch->solid_v,
+            color,
+        };
+    }
+
+    for (int sdx = 0; sdx < mesh.segments; ++sdx) {
+        uint16_t outer = (uint16_t) (span.base + sdx * 2);
+        uint16_t inner = (uint16_t) (outer + 1);
+        uint16_t* index = span.indices + sdx * 6;
+
+        index[0] = inner;
+        index[1] = (uint16_t) (outer + 2);
+        index[2] = outer;
+        index[3] = inner;
+        index[4] = (uint16_t) (inner + 2);
+        index[5] = (uint16_t) (outer + 2);
     }
 }
 
-static void clay_render_image(Clay_BoundingBox boundingBox, Clay_ImageRenderData* imageData) {
-    Texture2D imageTexture = *(Texture2D*) imageData->imageData;
-    Clay_Color tintColor = imageData->backgroundColor;
+static void clay_render_rectangle(
+    RenderBatch* batch,
+    CornerCache* corners,
+    Clay_BoundingBox boundingbox,
+    Clay_RectangleRenderData* rectangleData,
+    Color color
+) {
+    Clay_CornerRadius radii = rectangleData->cornerRadius;
 
-    if (
-        equal(tintColor.r, 0)
-        && equal(tintColor.g, 0)
-        && equal(tintColor.b, 0)
-        && equal(tintColor.a, 0)
-    ) {
-        tintColor = (Clay_Color) { 255, 255, 255, 255 };
+    if (radii.topLeft > 0 || radii.topRight > 0 || radii.bottomLeft > 0 || radii.bottomRight > 0) {
+        push_rounded_rect(batch, corners, clay_bbox_to_raylib_rectangle(boundingbox), radii, color);
+    } else {
+        render_batch_push_rect(batch, clay_bbox_to_raylib_rectangle(boundingbox), color);
     }
+}
 
-    DrawTexturePro(
-        imageTexture,
-        (Rectangle) { 0, 0, (float) imageTexture.width, (float) imageTexture.height },
-        (Rectangle) { boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height },
-        (Vector2) {},
-        0,
-        clay_color_to_raylib_color(tintColor)
+static void clay_render_image(
+    RenderBatch* batch,
+    ImageAtlas* images,
+    Clay_BoundingBox boundingBox,
+    Clay_ImageRenderData* imageData,
+    Color tint
+) {
+    Texture2D imageTexture = *(Texture2D*) imageData->imageData;
+    AtlasRegion region = image_atlas_region(images, imageTexture);
+    render_batch_push_quad(
+        batch,
+        region.texture_id,
+        clay_bbox_to_raylib_rectangle(boundingBox),
+        region.uv,
+        tint
     );
 }
 
-static void clay_render_border(Clay_BoundingBox boundingBox, Clay_BorderRenderData* borderData) {
+static void clay_render_border(
+    RenderBatch* batch,
+    CornerCache* corners,
+    Clay_BoundingBox boundingBox,
+    Clay_BorderRenderData* borderData,
+    Color color
+) {
     // Alias
     Clay_BorderRenderData* cfg = borderData;
 
     // Left border
     if (cfg->width.left > 0) {
-        DrawRectangle(
-            (int)roundf(boundingBox.x),
-            (int)roundf(boundingBox.y + cfg->cornerRadius.topLeft),
-            (int)cfg->width.left,
-            (int)roundf(boundingBox.height - cfg->cornerRadius.topLeft - cfg->cornerRadius.bottomLeft),
-            clay_color_to_raylib_color(cfg->color)
+        render_batch_push_rect(
+            batch,
+            (Rectangle) {
+                roundf(boundingBox.x),
+                roundf(boundingBox.y + cfg->cornerRadius.topLeft),
+                cfg->width.left,
+                roundf(boundingBox.height - cfg->cornerRadius.topLeft - cfg->cornerRadius.bottomLeft),
+            },
+            color
         );
     }
 
     // Right border
     if (cfg->width.right > 0) {
-        DrawRectangle(
-            (int)roundf(boundingBox.x + boundingBox.width - cfg->width.right),
-            (int)roundf(boundingBox.y + cfg->cornerRadius.topRight),
-            (int)cfg->width.right,
-            (int)roundf(boundingBox.height - cfg->cornerRadius.topRight - cfg->cornerRadius.bottomRight),
-            clay_color_to_raylib_color(cfg->color)
+        render_batch_push_rect(
+            batch,
+            (Rectangle) {
+                roundf(boundingBox.x + boundingBox.width - cfg->width.right),
+                roundf(boundingBox.y + cfg->cornerRadius.topRight),
+                cfg->width.right,
+                roundf(boundingBox.height - cfg->cornerRadius.topRight - cfg->cornerRadius.bottomRight),
+            },
+            color
         );
     }
 
     // Top border
     if (cfg->width.top > 0) {
-        DrawRectangle(
-            (int)roundf(boundingBox.x + cfg->cornerRadius.topLeft),
-            (int)roundf(boundingBox.y),
-            (int)roundf(boundingBox.width - cfg->cornerRadius.topLeft - cfg->cornerRadius.topRight),
-            (int)cfg->width.top,
-            clay_color_to_raylib_color(cfg->color)
+        render_batch_push_rect(
+            batch,
+            (Rectangle) {
+                roundf(boundingBox.x + cfg->cornerRadius.topLeft),
+                roundf(boundingBox.y),
+                roundf(boundingBox.width - cfg->cornerRadius.topLeft - cfg->cornerRadius.topRight),
+                cfg->width.top,
+            },
+            color
         );
     }
 
     // Bottom border
     if (cfg->width.bottom > 0) {
-        DrawRectangle(
-            (int)roundf(boundingBox.x + cfg->cornerRadius.bottomLeft),
-            (int)roundf(boundingBox.y + boundingBox.height - cfg->width.bottom),
-            (int)roundf(boundingBox.width - cfg->cornerRadius.bottomLeft - cfg->cornerRadius.bottomRight),
-            (int)cfg->width.bottom,
-            clay_color_to_raylib_color(cfg->color)
+        render_batch_push_rect(
+            batch,
+            (Rectangle) {
+                roundf(boundingBox.x + cfg->cornerRadius.bottomLeft),
+                roundf(boundingBox.y + boundingBox.height - cfg->width.bottom),
+                roundf(boundingBox.width - cfg->cornerRadius.bottomLeft - cfg->cornerRadius.bottomRight),
+                cfg->width.bottom,
+            },
+            color
         );
     }
 
     if (cfg->cornerRadius.topLeft > 0) {
-        DrawRing(
+        push_corner_ring(
+            batch,
+            corners,
             (Vector2) {
                 .x = roundf(boundingBox.x + cfg->cornerRadius.topLeft),
                 .y = roundf(boundingBox.y + cfg->cornerRadius.topLeft)
             },
-            roundf(cfg->cornerRadius.topLeft - cfg->width.top),
             cfg->cornerRadius.topLeft,
-            180,
-            270,
-            10,
-            clay_color_to_raylib_color(cfg->color)
+            cfg->width.top,
+            2,
+            color
         );
     }
     if (cfg->cornerRadius.topRight > 0) {
-        DrawRing(
+        push_corner_ring(
+            batch,
+            corners,
             (Vector2) {
                 .x = roundf(boundingBox.x + boundingBox.width - cfg->cornerRadius.topRight),
                 .y = roundf(boundingBox.y + cfg->cornerRadius.topRight)
             },
-            roundf(cfg->cornerRadius.topRight - cfg->width.top),
             cfg->cornerRadius.topRight,
-            270,
-            360,
-            10,
-            clay_color_to_raylib_color(cfg->color)
+            cfg->width.top,
+            3,
+            color
         );
     }
     if (cfg->cornerRadius.bottomLeft > 0) {
-        DrawRing(
+        push_corner_ring(
+            batch,
+            corners,
             (Vector2) {
                 .x = roundf(boundingBox.x + cfg->cornerRadius.bottomLeft),
                 .y = roundf(boundingBox.y + boundingBox.height - cfg->cornerRadius.bottomLeft)
             },
-            roundf(cfg->cornerRadius.bottomLeft - cfg->width.bottom),
             cfg->cornerRadius.bottomLeft,
-            90,
-            180,
-            10,
-            clay_color_to_raylib_color(cfg->color)
+            cfg->width.bottom,
+            1,
+            color
         );
     }
     if (cfg->cornerRadius.bottomRight > 0) {
-        DrawRing(
+        push_corner_ring(
+            batch,
+            corners,
             (Vector2) {
                 .x = roundf(boundingBox.x + boundingBox.width - cfg->cornerRadius.bottomRight),
                 .y = roundf(boundingBox.y + boundingBox.height - cfg->cornerRadius.bottomRight)
             },
-            roundf(cfg->cornerRadius.bottomRight - cfg->width.bottom),
             cfg->cornerRadius.bottomRight,
-            0.1f,
-            90,
-            10,
-            clay_color_to_raylib_color(cfg->color)
+            cfg->width.bottom,
+            0,
+            color
         );
     }
 }
 
-void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands) {
-    for (int idx = 0; idx < renderCommands.length; ++idx)
+static RectInstance rectangle_instance(
+    Clay_BoundingBox boundingBox,
+    Clay_RectangleRenderData* rectangleData,
+    Color color
+) {
+    Clay_CornerRadius radii = rectangleData->cornerRadius;
+    return (RectInstance) {
+        .x = boundingBox.x,
+        .y = boundingBox.y,
+        .width = boundingBox.width,
+        .height = boundingBox.height,
+        .radius = { radii.topLeft, radii.topRight, radii.bottomRight, radii.bottomLeft },
+        .color = color,
+    };
+}
+
+static RectInstance border_instance(Clay_BoundingBox boundingBox, Clay_BorderRenderData* borderData, Color color) {
+    Clay_CornerRadius radii = borderData->cornerRadius;
+    Clay_BorderWidth width = borderData->width;
+    return (RectInstance) {
+        .x = boundingBox.x,
+        .y = boundingBox.y,
+        .width = boundingBox.width,
+        .height = boundingBox.height,
+        .radius = { radii.topLeft, radii.topRight, radii.bottomRight, radii.bottomLeft },
+        .border = { width.left, width.right, width.top, width.bottom },
+        .color = color,
+    };
+}
+
+static void render_commands(
+    Clay_Raylib_Renderer* renderer,
+    Clay_RenderCommandArray* renderCommands,
+    int32_t begin,
+    int32_t end,
+    Vector2 origin,
+    Rectangle clip,
+    bool inLayer
+);
+
+// Index of the SCISSOR_END closing the SCISSOR_START at `start`
+static int32_t matching_scissor_end(Clay_RenderCommandArray* renderCommands, int32_t start) {
+    int depth = 0;
+    for (int32_t idx = start; idx < renderCommands->length; ++idx) {
+        Clay_RenderCommandType type = Clay_RenderCommandArray_Get(renderCommands, idx)->commandType;
+        if (type == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START)
+            depth += 1;
+        else if (type == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END && --depth == 0)
+            return idx;
+    }
+
+    return renderCommands->length;
+}
+
+// The layer a clipping element's userData points at, nullptr if it's something else
+static Clay_Raylib_Layer* layer_of(const Clay_RenderCommand* renderCommand) {
+    const uint32_t* tag = (const uint32_t*) renderCommand->userData;
+    return tag != nullptr && *tag == CLAY_RAYLIB_LAYER_TAG ? (Clay_Raylib_Layer*) renderCommand->userData : nullptr;
+}
+
+static void begin_scissor(Rectangle clip, Vector2 origin) {
+    BeginScissorMode(
+        (int) roundf(clip.x - origin.x),
+        (int) roundf(clip.y - origin.y),
+        (int) roundf(clip.width),
+        (int) roundf(clip.height)
+    );
+}
+
+// Draws the commands between a layer's SCISSOR_START and its SCISSOR_END into the layer's
+// texture if they changed, then blits the texture in their place. `visible` is the part of
+// the target the enclosing clipping element leaves, `enclosed` whether there is one, its
+// scissor is active again once this returns.
+static void render_layer(
+    Clay_Raylib_Renderer* renderer,
+    Clay_RenderCommandArray* renderCommands,
+    int32_t start,
+    int32_t end,
+    Rectangle visible,
+    Vector2 origin,
+    bool enclosed
+) {
+    Clay_RenderCommand* open = Clay_RenderCommandArray_Get(renderCommands, start);
+    Clay_Raylib_Layer* layer = layer_of(open);
+
+    Rectangle bounds = {
+        roundf(open->boundingBox.x),
+        roundf(open->boundingBox.y),
+        roundf(open->boundingBox.width),
+        roundf(open->boundingBox.height),
+    };
+    if (bounds.width <= 0 || bounds.height <= 0)
+        return;
+
+    // Relative to the layer, so moving it around as a whole still reuses the texture.
+    // The opening command is included for the size.
+    uint64_t fingerprint = fingerprint_render_commands_at(
+        renderCommands->internalArray + start,
+        end - start,
+        (Clay_Vector2) { bounds.x, bounds.y }
+    );
+
+    render_batch_flush(&renderer->batch);
+    rect_batch_flush(&renderer->rects);
+    // An outer scissor would also clip drawing into the texture
+    EndScissorMode();
+
+    int width = (int) bounds.width;
+    int height = (int) bounds.height;
+    if (layer->target.texture.width != width || layer->target.texture.height != height) {
+        if (layer->target.id != 0)
+            UnloadRenderTexture(layer->target);
+
+        layer->target = LoadRenderTexture(width, height);
+        layer->valid = false;
+    }
+
+    if (layer->target.id == 0) {
+        // Out of video memory or similar, draw like a plain clipping element
+        Rectangle inner = intersect(visible, bounds);
+        begin_scissor(inner, origin);
+        render_commands(renderer, renderCommands, start + 1, end, origin, inner, true);
+        if (enclosed)
+            begin_scissor(visible, origin);
+        else
+            EndScissorMode();
+        return;
+    }
+
+    if (!layer->valid || layer->fingerprint != fingerprint) {
+        BeginTextureMode(layer->target);
+        ClearBackground(BLANK);
+        rlTranslatef(-bounds.x, -bounds.y, 0);
+
+        // Alpha accumulates the usual way while color comes out premultiplied,
+        // so translucent content composites correctly when the texture is blitted
+        rlSetBlendFactorsSeparate(
+            RL_SRC_ALPHA,
+            RL_ONE_MINUS_SRC_ALPHA,
+            RL_ONE,
+            RL_ONE_MINUS_SRC_ALPHA,
+            RL_FUNC_ADD,
+            RL_FUNC_ADD
+        );
+        BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+        render_commands(renderer, renderCommands, start + 1, end, (Vector2) { bounds.x, bounds.y }, bounds, true);
+        EndBlendMode();
+
+        EndTextureMode();
+
+        layer->fingerprint = fingerprint;
+        layer->valid = true;
+        layer->redraws += 1;
+    } else {
+        layer->reuses += 1;
+    }
+
+    // The texture holds the whole layer, the enclosing clipping element still cuts it
+    if (enclosed)
+        begin_scissor(visible, origin);
+
+    // Render textures come out upside down
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    render_batch_push_quad(&renderer->batch, layer->target.texture.id, bounds, (Rectangle) { 0, 1, 1, -1 }, WHITE);
+    render_batch_flush(&renderer->batch);
+    EndBlendMode();
+}
+
+// `origin` is where the render target sits on screen, scissor rectangles are given relative to it.
+// `clip` is the visible part of the target in screen coordinates, commands entirely outside the
+// innermost clipping element are dropped before they reach raylib. Layers can't nest, inside
+// one further layers draw as plain clipping elements.
+static void render_commands(
+    Clay_Raylib_Renderer* renderer,
+    Clay_RenderCommandArray* renderCommands,
+    int32_t begin,
+    int32_t end,
+    Vector2 origin,
+    Rectangle clip,
+    bool inLayer
+) {
+    RenderBatch* batch = &renderer->batch;
+    RectBatch* rects = &renderer->rects;
+    DrawList* draws = &renderer->draws;
+    Clay_Raylib_CullStats* stats = &renderer->cull_stats;
+
+    // clips[0] is the whole target, clipping elements push their intersection with the top
+    Rectangle clips[MAX_CLIP_DEPTH + 1] = { clip };
+    int depth = 0;
+
+    for (int32_t idx = begin; idx < end; ++idx)
     {
-        Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(&renderCommands, idx);
-        Clay_BoundingBox boundingBox = {
-            .x = roundf(renderCommand->boundingBox.x),
-            .y = roundf(renderCommand->boundingBox.y),
-            .width = roundf(renderCommand->boundingBox.width),
-            .height = roundf(renderCommand->boundingBox.height)
-        };
+        // Scissors never move, so positions and command indices agree on them
+        int32_t command = draws->order[idx];
+        Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(renderCommands, command);
+        DrawRect rect = draws->rects[command];
+        Clay_BoundingBox boundingBox = { (float) rect.x, (float) rect.y, (float) rect.width, (float) rect.height };
+        Color color = draws->colors[command];
+
+        Rectangle visible = clips[depth < MAX_CLIP_DEPTH ? depth : MAX_CLIP_DEPTH];
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START) {
+            // A clipping element out of sight hides everything up to its end, layer or not
+            if (!overlaps(boundingBox, visible)) {
+                int32_t close = matching_scissor_end(renderCommands, idx);
+                close = close < end ? close : end - 1;
+                stats->culled += (uint64_t) (close - idx + 1);
+                idx = close;
+                continue;
+            }
+        } else if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+            if (!overlaps(boundingBox, visible)) {
+                stats->culled += 1;
+                continue;
+            }
+            stats->drawn += 1;
+        }
+
+        // Instances and geometry are separate draws, switching between them flushes the
+        // other batch so commands still land in order
+        bool instanced = renderer->instanced_rects && (
+            renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE
+            || renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_BORDER
+        );
+        if (instanced)
+            render_batch_flush(batch);
+        else
+            rect_batch_flush(rects);
 
         switch (renderCommand->commandType) {
             case CLAY_RENDER_COMMAND_TYPE_TEXT:
-                clay_render_text(boundingBox, &renderCommand->renderData.text);
+                clay_render_text(renderer, boundingBox, &renderCommand->renderData.text, color);
                 break;
 
             case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
-                clay_render_rectangle(boundingBox, &renderCommand->renderData.rectangle);
+                if (instanced)
+                    rect_batch_push(rects, rectangle_instance(boundingBox, &renderCommand->renderData.rectangle, color));
+                else
+                    clay_render_rectangle(batch, &renderer->corners, boundingBox, &renderCommand->renderData.rectangle, color);
                 break;
 
             case CLAY_RENDER_COMMAND_TYPE_IMAGE:
-                clay_render_image(boundingBox, &renderCommand->renderData.image);
+                clay_render_image(batch, &renderer->images, boundingBox, &renderCommand->renderData.image, color);
                 break;
 
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
-                BeginScissorMode(
-                    (int) roundf(boundingBox.x),
-                    (int) roundf(boundingBox.y),
-                    (int) roundf(boundingBox.width),
-                    (int) roundf(boundingBox.height)
-                );
+                if (!inLayer && layer_of(renderCommand) != nullptr) {
+                    int32_t close = matching_scissor_end(renderCommands, idx);
+                    render_layer(renderer, renderCommands, idx, close, visible, origin, depth > 0);
+                    idx = close;
+                    break;
+                }
+
+                depth += 1;
+                Rectangle inner = intersect(visible, clay_bbox_to_raylib_rectangle(boundingBox));
+                if (depth <= MAX_CLIP_DEPTH)
+                    clips[depth] = inner;
+
+                render_batch_flush(batch);
+                begin_scissor(inner, origin);
                 break;
             }
 
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
-                EndScissorMode();
+                render_batch_flush(batch);
+                depth = depth > 0 ? depth - 1 : 0;
+                // Back to the enclosing clipping element, if any. A layer keeps its own bounds.
+                if (depth > 0 || inLayer)
+                    begin_scissor(clips[depth < MAX_CLIP_DEPTH ? depth : MAX_CLIP_DEPTH], origin);
+                else
+                    EndScissorMode();
                 break;
 
             case CLAY_RENDER_COMMAND_TYPE_BORDER:
-                clay_render_border(boundingBox, &renderCommand->renderData.border);
+                if (instanced)
+                    rect_batch_push(rects, border_instance(boundingBox, &renderCommand->renderData.border, color));
+                else
+                    clay_render_border(batch, &renderer->corners, boundingBox, &renderCommand->renderData.border, color);
                 break;
 
             case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                Clay_CustomRenderData* customData = &renderCommand->renderData.custom;
+                const CustomHandler* handler = custom_registry_find(&renderer->customs, customData->customData);
+                if (handler != nullptr)
+                    handler->draw(handler->context, batch, boundingBox, customData);
+                break;
             }
 
             case CLAY_RENDER_COMMAND_TYPE_NONE:
@@ -325,4 +874,120 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands) {
                 exit(1);
         }
     }
+
+    render_batch_flush(batch);
+    rect_batch_flush(rects);
+}
+
+[[gnu::always_inline]]
+static inline DrawRect round_rect(Clay_BoundingBox box) {
+    return (DrawRect) { (int32_t) roundf(box.x), (int32_t) roundf(box.y), (int32_t) roundf(box.width), (int32_t) roundf(box.height) };
+}
+
+// Flattens the commands into the draw list, with the color, rounded box and draw key
+// each one is drawn with, then orders them to switch textures and shaders less
+static bool compile_draw_list(Clay_Raylib_Renderer* renderer, Clay_RenderCommandArray* renderCommands) {
+    DrawList* draws = &renderer->draws;
+    if (!draw_list_reserve(draws, renderCommands->length))
+        return false;
+
+    uint32_t solid_key = draw_key(renderer->batch.solid_texture_id, DRAW_PIPELINE_GEOMETRY);
+    uint32_t rect_key = renderer->instanced_rects ? draw_key(0, DRAW_PIPELINE_INSTANCED) : solid_key;
+
+    for (int32_t idx = 0; idx < renderCommands->length; ++idx) {
+        Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(renderCommands, idx);
+        Clay_RenderData* data = &renderCommand->renderData;
+        DrawRect rect = round_rect(renderCommand->boundingBox);
+        DrawRect bounds = rect;
+        Color color = {};
+        uint32_t key = DRAW_KEY_FIXED;
+
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+                color = clay_color_to_raylib_color(data->rectangle.backgroundColor);
+                key = rect_key;
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+                color = clay_color_to_raylib_color(data->border.color);
+                key = rect_key;
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                const FontMetrics* metrics = font_registry_get(&renderer->fonts, data->text.fontId, data->text.fontSize);
+                color = clay_color_to_raylib_color(data->text.textColor);
+                key = draw_key(metrics->font.texture.id, metrics->sdf ? DRAW_PIPELINE_SDF : DRAW_PIPELINE_GEOMETRY);
+
+                // Glyph quads stick out of the box by their padding, descenders can too
+                int32_t margin = data->text.fontSize / 8 + 1;
+                bounds = (DrawRect) { rect.x - margin, rect.y - margin, rect.width + margin * 2, rect.height + margin * 2 };
+                break;
+            }
+
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                Clay_Color tint = data->image.backgroundColor;
+                if (equal(tint.r, 0) && equal(tint.g, 0) && equal(tint.b, 0) && equal(tint.a, 0))
+                    tint = (Clay_Color) { 255, 255, 255, 255 };
+
+                AtlasRegion region = image_atlas_region(&renderer->images, *(Texture2D*) data->image.imageData);
+                color = clay_color_to_raylib_color(tint);
+                key = draw_key(region.texture_id, DRAW_PIPELINE_GEOMETRY);
+                break;
+            }
+
+            // Handlers may draw with anything
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+                color = clay_color_to_raylib_color(data->custom.backgroundColor);
+                key = DRAW_KEY_ALONE;
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+            case CLAY_RENDER_COMMAND_TYPE_NONE:
+                break;
+        }
+
+        draws->rects[idx] = rect;
+        draws->bounds[idx] = bounds;
+        draws->colors[idx] = color;
+        draws->keys[idx] = key;
+        draws->z_indices[idx] = renderCommand->zIndex;
+    }
+
+    if (renderer->sort_draws)
+        draw_list_sort(draws);
+    else
+        draw_list_keep_order(draws);
+
+    return true;
+}
+
+void Clay_Raylib_Render(Clay_Raylib_Renderer* renderer, Clay_RenderCommandArray renderCommands) {
+    // Copying images into the atlas switches render targets, so it all happens up front
+    image_atlas_begin(&renderer->images);
+    for (int idx = 0; idx < renderCommands.length; ++idx) {
+        Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(&renderCommands, idx);
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_IMAGE)
+            image_atlas_place(&renderer->images, *(Texture2D*) renderCommand->renderData.image.imageData);
+    }
+    // Same for custom elements updating their own textures
+    custom_registry_prepare(&renderer->customs, renderCommands);
+
+    if (!compile_draw_list(renderer, &renderCommands)) {
+        fputs("Warning: Out of memory for the draw list, skipping the frame\n", stderr);
+        return;
+    }
+
+    render_batch_begin(&renderer->batch);
+    rect_batch_begin(&renderer->rects);
+
+    Rectangle screen = { 0, 0, (float) GetScreenWidth(), (float) GetScreenHeight() };
+    render_commands(renderer, &renderCommands, 0, renderCommands.length, (Vector2) { 0, 0 }, screen, false);
+}
+
+void Clay_Raylib_UnloadLayer(Clay_Raylib_Layer* layer) {
+    if (layer->target.id != 0)
+        UnloadRenderTexture(layer->target);
+
+    *layer = (Clay_Raylib_Layer) { .tag = CLAY_RAYLIB_LAYER_TAG };
 }
@@ -1,11 +1,86 @@
 #pragma once
 
 #include "clay.h"
+#include "custom_registry.h"
+#include "font_registry.h"
+#include "raylib.h"
+#include "text_run_cache.h"
 
+#include <stdint.h>
 
-void Clay_Raylib_Initialize(int width, int height, const char* title, unsigned int flags);
-void Clay_Raylib_Close();
 
-void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands);
+// Marks userData that points at a Clay_Raylib_Layer, "LAYR"
+constexpr uint32_t CLAY_RAYLIB_LAYER_TAG = 0x4C415952;
 
+// Retained layer for a subtree that rarely changes. Point the userData of a clipping element
+// (.clip) at one and the renderer draws the element and its children into a texture once,
+// then only blits it until their render commands change. Moving the element as a whole
+// keeps the texture. Initialize it as { .tag = CLAY_RAYLIB_LAYER_TAG } and release it with
+// Clay_Raylib_UnloadLayer().
+//
+// userData is free for other uses, the renderer only takes it for a layer when it points at
+// a struct starting with a uint32_t that holds CLAY_RAYLIB_LAYER_TAG. Anything else a
+// clipping element's userData points at has to be at least that big and start differently.
+typedef struct Clay_Raylib_Layer {
+    uint32_t tag;
+    RenderTexture2D target;
+    uint64_t fingerprint;
+    bool valid;
+
+    // Frames the texture was redrawn and reused
+    uint64_t redraws;
+    uint64_t reuses;
+} Clay_Raylib_Layer;
+
+// Totals since the renderer was created. Commands entirely outside the window or the clipping
+// element they're in are culled instead of drawn, scissor commands count as neither unless
+// their whole clipping element is culled.
+typedef struct Clay_Raylib_CullStats {
+    uint64_t culled;
+    uint64_t drawn;
+} Clay_Raylib_CullStats;
+
+// Everything the renderer keeps between frames, so nothing is shared between instances
+typedef struct Clay_Raylib_Renderer Clay_Raylib_Renderer;
+
+
+Clay_Raylib_Renderer* Clay_Raylib_Initialize(int width, int height, const char* title, unsigned int flags);
+void Clay_Raylib_Close(Clay_Raylib_Renderer* renderer);
+
+void Clay_Raylib_Render(Clay_Raylib_Renderer* renderer, Clay_RenderCommandArray renderCommands);
+void Clay_Raylib_UnloadLayer(Clay_Raylib_Layer* layer);
+
+// Draws rectangles and borders as instanced quads shaded by a rounded box SDF instead of
+// tessellating them. On by default, returns whether it's in use, it needs GLSL 330.
+bool Clay_Raylib_UseInstancedRects(Clay_Raylib_Renderer* renderer, bool enabled);
+
+// Within each zIndex between clipping elements, commands drawn with the same texture and
+// shader are grouped wherever they don't overlap what they move past, so text, images and
+// rectangles interleaving on screen don't flush a batch each. Output looks the same. On by default.
+void Clay_Raylib_SortDraws(Clay_Raylib_Renderer* renderer, bool enabled);
+
+// Small images are copied into shared atlas pages the first time they're drawn. Call this
+// before unloading a texture that was drawn, a new texture could reuse its id.
+void Clay_Raylib_ForgetImage(Clay_Raylib_Renderer* renderer, Texture2D texture);
+
+// Fonts text is measured and drawn with, register more to use other fontIds
+FontRegistry* Clay_Raylib_GetFonts(Clay_Raylib_Renderer* renderer);
+
+// Laid out text kept across frames, for its hit and miss counts
+TextRunCache* Clay_Raylib_GetTextRuns(Clay_Raylib_Renderer* renderer);
+
+// Handlers that draw custom elements, see CustomRegistry for what customData has to look like
+CustomRegistry* Clay_Raylib_GetCustomHandlers(Clay_Raylib_Renderer* renderer);
+
+Clay_Raylib_CullStats Clay_Raylib_GetCullStats(Clay_Raylib_Renderer* renderer);
+
+// userData must be the FontRegistry of the renderer the text will be drawn with
 Clay_Dimensions Raylib_MeasureText(Clay_StringSlice text, Clay_TextElementConfig* config, void* userData);
+// Raylib_MeasureText for all words of a string in one call, see Clay_SetMeasureTextBatchFunction()
+Clay_Dimensions Raylib_MeasureTextBatch(
+    Clay_StringSlice text,
+    Clay_MeasureTextWord* words,
+    int32_t wordCount,
+    Clay_TextElementConfig* config,
+    void* userData
+);
@@ -0,0 +1,941 @@
+#include "clay_software.h"
+
+#include "../trace.h"
+#include "clay.h"
+#include "font_metrics.h"
+#include "raylib.h"
+#include "thread_pool.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+constexpr int MAX_FONTS = 16;
+
+// Clipping elements nested deeper than this clip to the deepest one kept, like the raylib backend
+constexpr int MAX_CLIP_DEPTH = 32;
+
+// Tiles are square, small enough to spread a frame over many threads and to keep a
+// tile's rows in cache while its commands are drawn
+constexpr int TILE_SIZE = 64;
+
+typedef struct SoftwareFont {
+    FontMetrics metrics;
+    // One byte of coverage per atlas texel, addressed through metrics.font.recs
+    uint8_t* coverage;
+    int atlas_width;
+} SoftwareFont;
+
+// Rectangle in pixels, half open
+typedef struct PixelRect {
+    int x0, y0;
+    int x1, y1;
+} PixelRect;
+
+// What drawing writes to: the framebuffer, limited to the scissor and the current tile
+typedef struct SoftwareTarget {
+    Color* pixels;
+    int width;
+    PixelRect clip;
+} SoftwareTarget;
+
+// Command as binned for the tiled path
+typedef struct SoftwareItem {
+    const Clay_RenderCommand* command;
+    // Scissor the command was issued under
+    PixelRect clip;
+    // Tiles the command touches, half open
+    int tile_x0, tile_y0;
+    int tile_x1, tile_y1;
+} SoftwareItem;
+
+struct Clay_Software_Renderer {
+    Color* pixels;
+    int width;
+    int height;
+
+    SoftwareFont fonts[MAX_FONTS];
+    int font_count;
+
+    // Threads tiles are rasterized on, thread_count 1 draws the whole frame in one go
+    ThreadPool pool;
+    bool pool_running;
+
+    SoftwareItem* items;
+    int32_t item_count;
+    int32_t item_capacity;
+
+    int tiles_x, tiles_y;
+    // Items drawn into tile t are tile_items[tile_starts[t]] to tile_items[tile_starts[t + 1]],
+    // in command order
+    int32_t* tile_starts;
+    int32_t* tile_items;
+    int32_t tile_item_capacity;
+
+    Color background;
+};
+
+// Walks the glyphs of a text command, positions are the glyph's pen position
+typedef struct GlyphCursor {
+    const SoftwareFont* font;
+    const Clay_TextRenderData* text;
+    float scale;
+    float line_x;
+    float x, y;
+    int32_t offset;
+} GlyphCursor;
+
+// Rounded box in pixels, the edges sit between pixels at whole coordinates
+typedef struct SoftwareBox {
+    float x0, y0;
+    float x1, y1;
+    // Top left, top right, bottom right, bottom left
+    float radius[4];
+} SoftwareBox;
+
+
+[[gnu::always_inline]]
+static inline Color clay_color_to_raylib_color(Clay_Color clayColor) {
+    return (Color) {
+        .r = (unsigned char) roundf(clayColor.r),
+        .g = (unsigned char) roundf(clayColor.g),
+        .b = (unsigned char) roundf(clayColor.b),
+        .a = (unsigned char) roundf(clayColor.a),
+    };
+}
+
+// x / 255 rounded, exact for every product of two bytes
+[[gnu::always_inline]]
+static inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// Source over with straight alpha, `alpha` already includes the color's own
+[[gnu::always_inline]]
+static inline void blend_pixel(Color* pixel, Color color, uint32_t alpha) {
+    uint32_t inverse = 255 - alpha;
+    pixel->r = (unsigned char) div255(pixel->r * inverse + color.r * alpha);
+    pixel->g = (unsigned char) div255(pixel->g * inverse + color.g * alpha);
+    pixel->b = (unsigned char) div255(pixel->b * inverse + color.b * alpha);
+    pixel->a = (unsigned char) div255(pixel->a * inverse + 255 * alpha);
+}
+
+static void fill_span(Color* span, int count, Color color, uint32_t alpha) {
+    if (alpha == 0 || count <= 0)
+        return;
+
+    Color opaque = { color.r, color.g, color.b, 255 };
+    uint32_t packed;
+    memcpy(&packed, &opaque, sizeof(packed));
+
+    int idx = 0;
+    if (alpha == 255) {
+#if defined(__SSE2__)
+        __m128i fill = _mm_set1_epi32((int) packed);
+        for (; idx + 4 <= count; idx += 4)
+            _mm_storeu_si128((__m128i*) (span + idx), fill);
+#endif
+        for (; idx < count; ++idx)
+            span[idx] = opaque;
+        return;
+    }
+
+#if defined(__SSE2__)
+    // Four pixels at a time, widened to 16 bits per channel. Weights add up to 255,
+    // so dst * (255 - alpha) + src * alpha never leaves 16 bits.
+    __m128i zero = _mm_setzero_si128();
+    __m128i source = _mm_mullo_epi16(
+        _mm_unpacklo_epi8(_mm_set1_epi32((int) packed), zero),
+        _mm_set1_epi16((short) alpha)
+    );
+    __m128i inverse = _mm_set1_epi16((short) (255 - alpha));
+    __m128i bias = _mm_set1_epi16(128);
+
+    for (; idx + 4 <= count; idx += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*) (span + idx));
+
+        __m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inverse);
+        __m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inverse);
+        low = _mm_add_epi16(_mm_add_epi16(low, source), bias);
+        high = _mm_add_epi16(_mm_add_epi16(high, source), bias);
+        low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+        high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+        _mm_storeu_si128((__m128i*) (span + idx), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for (; idx < count; ++idx)
+        blend_pixel(&span[idx], color, alpha);
+}
+
+[[gnu::always_inline]]
+static inline uint32_t coverage_alpha(Color color, float coverage) {
+    return (uint32_t) lroundf((float) color.a * fminf(fmaxf(coverage, 0), 1));
+}
+
+// Fills [left, right) of a row, pixels the edges cut through get partial coverage
+static void fill_row(SoftwareTarget* target, int y, float left, float right, Color color) {
+    left = fmaxf(left, (float) target->clip.x0);
+    right = fminf(right, (float) target->clip.x1);
+    if (right <= left)
+        return;
+
+    Color* row = target->pixels + (ptrdiff_t) y * target->width;
+    int first = (int) floorf(left);
+    int last = (int) ceilf(right) - 1;
+
+    if (first == last) {
+        blend_pixel(&row[first], color, coverage_alpha(color, right - left));
+        return;
+    }
+
+    blend_pixel(&row[first], color, coverage_alpha(color, (float) (first + 1) - left));
+    fill_span(row + first + 1, last - first - 1, color, color.a);
+    blend_pixel(&row[last], color, coverage_alpha(color, right - (float) last));
+}
+
+// Horizontal extent of the box on the row through `y`, false when the row misses it
+static bool box_row(const SoftwareBox* box, float y, float* left, float* right) {
+    if (y < box->y0 || y >= box->y1)
+        return false;
+
+    *left = box->x0;
+    *right = box->x1;
+
+    float top_left = box->radius[0];
+    float top_right = box->radius[1];
+    float bottom_right = box->radius[2];
+    float bottom_left = box->radius[3];
+
+    if (y < box->y0 + top_left) {
+        float dy = box->y0 + top_left - y;
+        *left = box->x0 + top_left - sqrtf(fmaxf(top_left * top_left - dy * dy, 0));
+    } else if (y > box->y1 - bottom_left) {
+        float dy = y - (box->y1 - bottom_left);
+        *left = box->x0 + bottom_left - sqrtf(fmaxf(bottom_left * bottom_left - dy * dy, 0));
+    }
+
+    if (y < box->y0 + top_right) {
+        float dy = box->y0 + top_right - y;
+        *right = box->x1 - top_right + sqrtf(fmaxf(top_right * top_right - dy * dy, 0));
+    } else if (y > box->y1 - bottom_right) {
+        float dy = y - (box->y1 - bottom_right);
+        *right = box->x1 - bottom_right + sqrtf(fmaxf(bottom_right * bottom_right - dy * dy, 0));
+    }
+
+    return *right > *left;
+}
+
+// Fills `outer`, minus `inner` when it isn't nullptr. Rows are sampled at pixel centers.
+static void fill_box(SoftwareTarget* target, SoftwareBox outer, const SoftwareBox* inner, Color color) {
+    float max_radius = fminf(outer.x1 - outer.x0, outer.y1 - outer.y0) / 2;
+    for (int cdx = 0; cdx < 4; ++cdx)
+        outer.radius[cdx] = fminf(outer.radius[cdx], max_radius);
+
+    int y0 = CLAY__MAX((int) floorf(outer.y0), target->clip.y0);
+    int y1 = CLAY__MIN((int) ceilf(outer.y1), target->clip.y1);
+
+    for (int y = y0; y < y1; ++y) {
+        float center = (float) y + 0.5f;
+
+        float left;
+        float right;
+        if (!box_row(&outer, center, &left, &right))
+            continue;
+
+        float inner_left;
+        float inner_right;
+        if (inner != nullptr && box_row(inner, center, &inner_left, &inner_right)) {
+            fill_row(target, y, left, inner_left, color);
+            fill_row(target, y, inner_right, right, color);
+        } else {
+            fill_row(target, y, left, right, color);
+        }
+    }
+}
+
+static SoftwareBox bbox_to_box(Clay_BoundingBox bbox, Clay_CornerRadius radii) {
+    return (SoftwareBox) {
+        .x0 = roundf(bbox.x),
+        .y0 = roundf(bbox.y),
+        .x1 = roundf(bbox.x + bbox.width),
+        .y1 = roundf(bbox.y + bbox.height),
+        .radius = { radii.topLeft, radii.topRight, radii.bottomRight, radii.bottomLeft },
+    };
+}
+
+
+static void render_border(SoftwareTarget* target, Clay_BoundingBox bbox, const Clay_BorderRenderData* border) {
+    SoftwareBox outer = bbox_to_box(bbox, border->cornerRadius);
+    float left = border->width.left;
+    float right = border->width.right;
+    float top = border->width.top;
+    float bottom = border->width.bottom;
+
+    // Same inset box the instanced rect shader cuts out
+    SoftwareBox inner = {
+        .x0 = outer.x0 + left,
+        .y0 = outer.y0 + top,
+        .x1 = outer.x1 - right,
+        .y1 = outer.y1 - bottom,
+        .radius = {
+            fmaxf(outer.radius[0] - fmaxf(left, top), 0),
+            fmaxf(outer.radius[1] - fmaxf(right, top), 0),
+            fmaxf(outer.radius[2] - fmaxf(right, bottom), 0),
+            fmaxf(outer.radius[3] - fmaxf(left, bottom), 0),
+        },
+    };
+
+    fill_box(target, outer, &inner, clay_color_to_raylib_color(border->color));
+}
+
+static const SoftwareFont* text_font(const Clay_Software_Renderer* renderer, uint16_t fontId) {
+    if (renderer->font_count == 0)
+        return nullptr;
+
+    return &renderer->fonts[fontId < renderer->font_count ? fontId : 0];
+}
+
+static GlyphCursor glyph_cursor(const SoftwareFont* font, const Clay_TextRenderData* text, Clay_BoundingBox bbox) {
+    return (GlyphCursor) {
+        .font = font,
+        .text = text,
+        .scale = (float) text->fontSize / (float) font->metrics.font.baseSize,
+        .line_x = roundf(bbox.x),
+        .x = roundf(bbox.x),
+        .y = roundf(bbox.y),
+    };
+}
+
+// Next glyph with any pixels to it, false at the end of the text
+static bool next_glyph(GlyphCursor* cursor, int* glyph, float* x, float* y) {
+    const FontMetrics* metrics = &cursor->font->metrics;
+    Clay_StringSlice slice = cursor->text->stringContents;
+
+    while (cursor->offset < slice.length) {
+        int32_t size;
+        int32_t codepoint = utf8_decode(slice.chars + cursor->offset, slice.length - cursor->offset, &size);
+        cursor->offset += size;
+
+        if (codepoint == '\n') {
+            cursor->x = cursor->line_x;
+            cursor->y += (float) cursor->text->fontSize;
+            continue;
+        }
+
+        *glyph = font_metrics_glyph_index(metrics, codepoint);
+        *x = cursor->x;
+        *y = cursor->y;
+        cursor->x += metrics->glyph_advance[*glyph] * cursor->scale + (float) cursor->text->letterSpacing;
+
+        if (codepoint != ' ' && codepoint != '\t')
+            return true;
+    }
+
+    return false;
+}
+
+// Pixels the glyph's nearest texel sampling can touch, before clipping
+static PixelRect glyph_rect(const SoftwareFont* font, int glyph, float x, float y, float scale) {
+    Rectangle rec = font->metrics.font.recs[glyph];
+    GlyphInfo info = font->metrics.font.glyphs[glyph];
+
+    float left = x + (float) info.offsetX * scale;
+    float top = y + (float) info.offsetY * scale;
+    return (PixelRect) {
+        .x0 = (int) floorf(left),
+        .y0 = (int) floorf(top),
+        .x1 = (int) ceilf(left + rec.width * scale),
+        .y1 = (int) ceilf(top + rec.height * scale),
+    };
+}
+
+static void render_glyph(
+    SoftwareTarget* target,
+    const SoftwareFont* font,
+    int glyph,
+    float x,
+    float y,
+    float scale,
+    Color color
+) {
+    Rectangle rec = font->metrics.font.recs[glyph];
+    GlyphInfo info = font->metrics.font.glyphs[glyph];
+
+    float left = x + (float) info.offsetX * scale;
+    float top = y + (float) info.offsetY * scale;
+    PixelRect extent = glyph_rect(font, glyph, x, y, scale);
+    int x0 = CLAY__MAX(extent.x0, target->clip.x0);
+    int y0 = CLAY__MAX(extent.y0, target->clip.y0);
+    int x1 = CLAY__MIN(extent.x1, target->clip.x1);
+    int y1 = CLAY__MIN(extent.y1, target->clip.y1);
+
+    // Nearest texel at each pixel center
+    for (int py = y0; py < y1; ++py) {
+        int ty = (int) (((float) py + 0.5f - top) / scale);
+        if (ty < 0 || ty >= (int) rec.height)
+            continue;
+
+        const uint8_t* texels = font->coverage + (ptrdiff_t) ((int) rec.y + ty) * font->atlas_width + (int) rec.x;
+        Color* row = target->pixels + (ptrdiff_t) py * target->width;
+        for (int px = x0; px < x1; ++px) {
+            int tx = (int) (((float) px + 0.5f - left) / scale);
+            if (tx < 0 || tx >= (int) rec.width)
+                continue;
+
+            uint32_t alpha = div255(texels[tx] * (uint32_t) color.a);
+            if (alpha != 0)
+                blend_pixel(&row[px], color, alpha);
+        }
+    }
+}
+
+static void render_text(
+    const Clay_Software_Renderer* renderer,
+    SoftwareTarget* target,
+    Clay_BoundingBox bbox,
+    const Clay_TextRenderData* text
+) {
+    const SoftwareFont* font = text_font(renderer, text->fontId);
+    if (font == nullptr)
+        return;
+
+    Color color = clay_color_to_raylib_color(text->textColor);
+    GlyphCursor cursor = glyph_cursor(font, text, bbox);
+
+    int glyph;
+    float x;
+    float y;
+    while (next_glyph(&cursor, &glyph, &x, &y)) {
+        PixelRect extent = glyph_rect(font, glyph, x, y, cursor.scale);
+        // Whole glyphs outside the target are common with tiles, skip them early
+        if (
+            extent.x1 <= target->clip.x0 || extent.x0 >= target->clip.x1
+            || extent.y1 <= target->clip.y0 || extent.y0 >= target->clip.y1
+        ) {
+            continue;
+        }
+
+        render_glyph(target, font, glyph, x, y, cursor.scale, color);
+    }
+}
+
+static void render_command(
+    const Clay_Software_Renderer* renderer,
+    SoftwareTarget* target,
+    const Clay_RenderCommand* renderCommand
+) {
+    Clay_BoundingBox bbox = renderCommand->boundingBox;
+
+    switch (renderCommand->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_TEXT:
+            render_text(renderer, target, bbox, &renderCommand->renderData.text);
+            break;
+
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            const Clay_RectangleRenderData* rectangle = &renderCommand->renderData.rectangle;
+            fill_box(
+                target,
+                bbox_to_box(bbox, rectangle->cornerRadius),
+                nullptr,
+                clay_color_to_raylib_color(rectangle->backgroundColor)
+            );
+            break;
+        }
+
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            const Clay_ImageRenderData* image = &renderCommand->renderData.image;
+            Color color = image->backgroundColor.a > 0
+                ? clay_color_to_raylib_color(image->backgroundColor)
+                : GRAY;
+            fill_box(target, bbox_to_box(bbox, image->cornerRadius), nullptr, color);
+            break;
+        }
+
+        case CLAY_RENDER_COMMAND_TYPE_BORDER:
+            render_border(target, bbox, &renderCommand->renderData.border);
+            break;
+
+        // Scissors are tracked by the callers, custom drawing is up to the application
+        // and it draws on the GPU
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+        case CLAY_RENDER_COMMAND_TYPE_NONE:
+            break;
+    }
+}
+
+static PixelRect scissor_rect(const Clay_Software_Renderer* renderer, Clay_BoundingBox bbox) {
+    return (PixelRect) {
+        .x0 = CLAY__MAX((int) roundf(bbox.x), 0),
+        .y0 = CLAY__MAX((int) roundf(bbox.y), 0),
+        .x1 = CLAY__MIN((int) roundf(bbox.x + bbox.width), renderer->width),
+        .y1 = CLAY__MIN((int) roundf(bbox.y + bbox.height), renderer->height),
+    };
+}
+
+static PixelRect intersect(PixelRect a, PixelRect b) {
+    return (PixelRect) {
+        .x0 = CLAY__MAX(a.x0, b.x0),
+        .y0 = CLAY__MAX(a.y0, b.y0),
+        .x1 = CLAY__MIN(a.x1, b.x1),
+        .y1 = CLAY__MIN(a.y1, b.y1),
+    };
+}
+
+// Nested clipping elements, each clips to its own box within all the ones around it and
+// ending it goes back to the enclosing one. The same rules the raylib backend follows.
+typedef struct ClipStack {
+    // clips[0] is the whole frame
+    PixelRect clips[MAX_CLIP_DEPTH + 1];
+    int depth;
+} ClipStack;
+
+static PixelRect clip_top(const ClipStack* stack) {
+    return stack->clips[stack->depth < MAX_CLIP_DEPTH ? stack->depth : MAX_CLIP_DEPTH];
+}
+
+static PixelRect clip_push(ClipStack* stack, PixelRect rect) {
+    PixelRect inner = intersect(clip_top(stack), rect);
+    stack->depth += 1;
+    if (stack->depth <= MAX_CLIP_DEPTH)
+        stack->clips[stack->depth] = inner;
+
+    return inner;
+}
+
+static PixelRect clip_pop(ClipStack* stack) {
+    stack->depth = stack->depth > 0 ? stack->depth - 1 : 0;
+    return clip_top(stack);
+}
+
+// Pixels a drawing command can touch before clipping, conservative but never too small,
+// a command missing from a tile it draws into would break the output
+static PixelRect command_rect(const Clay_Software_Renderer* renderer, const Clay_RenderCommand* renderCommand) {
+    Clay_BoundingBox bbox = renderCommand->boundingBox;
+    if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_TEXT) {
+        SoftwareBox box = bbox_to_box(bbox, (Clay_CornerRadius) {});
+        return (PixelRect) {
+            .x0 = (int) floorf(box.x0),
+            .y0 = (int) floorf(box.y0),
+            .x1 = (int) ceilf(box.x1),
+            .y1 = (int) ceilf(box.y1),
+        };
+    }
+
+    // Glyphs can stick out of the text's box, walk them the way drawing will
+    PixelRect rect = { INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN };
+    const Clay_TextRenderData* text = &renderCommand->renderData.text;
+    const SoftwareFont* font = text_font(renderer, text->fontId);
+    if (font == nullptr)
+        return rect;
+
+    GlyphCursor cursor = glyph_cursor(font, text, bbox);
+    int glyph;
+    float x;
+    float y;
+    while (next_glyph(&cursor, &glyph, &x, &y)) {
+        PixelRect extent = glyph_rect(font, glyph, x, y, cursor.scale);
+        rect.x0 = CLAY__MIN(rect.x0, extent.x0);
+        rect.y0 = CLAY__MIN(rect.y0, extent.y0);
+        rect.x1 = CLAY__MAX(rect.x1, extent.x1);
+        rect.y1 = CLAY__MAX(rect.y1, extent.y1);
+    }
+
+    return rect;
+}
+
+static void clear_rect(Clay_Software_Renderer* renderer, PixelRect rect) {
+    for (int y = rect.y0; y < rect.y1; ++y) {
+        Color* row = renderer->pixels + (ptrdiff_t) y * renderer->width;
+        for (int x = rect.x0; x < rect.x1; ++x)
+            row[x] = renderer->background;
+    }
+}
+
+// The reference path, also used with a single thread
+static void render_whole_frame(Clay_Software_Renderer* renderer, Clay_RenderCommandArray renderCommands) {
+    PixelRect frame = { 0, 0, renderer->width, renderer->height };
+    clear_rect(renderer, frame);
+
+    SoftwareTarget target = { .pixels = renderer->pixels, .width = renderer->width, .clip = frame };
+    ClipStack clips = { .clips = { frame } };
+    for (int idx = 0; idx < renderCommands.length; ++idx) {
+        Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(&renderCommands, idx);
+
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START)
+            target.clip = clip_push(&clips, scissor_rect(renderer, renderCommand->boundingBox));
+        else if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END)
+            target.clip = clip_pop(&clips);
+        else
+            render_command(renderer, &target, renderCommand);
+    }
+}
+
+static bool reserve_items(Clay_Software_Renderer* renderer, int32_t count) {
+    if (count <= renderer->item_capacity)
+        return true;
+
+    int32_t capacity = CLAY__MAX(renderer->item_capacity * 2, count);
+    SoftwareItem* items = (SoftwareItem*) realloc(renderer->items, sizeof(SoftwareItem) * (size_t) capacity);
+    if (items == nullptr)
+        return false;
+
+    renderer->items = items;
+    renderer->item_capacity = capacity;
+    return true;
+}
+
+static bool reserve_tile_items(Clay_Software_Renderer* renderer, int32_t count) {
+    if (count <= renderer->tile_item_capacity)
+        return true;
+
+    int32_t capacity = CLAY__MAX(renderer->tile_item_capacity * 2, count);
+    int32_t* tile_items = (int32_t*) realloc(renderer->tile_items, sizeof(int32_t) * (size_t) capacity);
+    if (tile_items == nullptr)
+        return false;
+
+    renderer->tile_items = tile_items;
+    renderer->tile_item_capacity = capacity;
+    return true;
+}
+
+// Sorts the drawing commands into per tile lists, keeping their order within every tile.
+// Counts first and fills second so every list is a slice of one array.
+static bool bin_commands(Clay_Software_Renderer* renderer, Clay_RenderCommandArray renderCommands) {
+    if (!reserve_items(renderer, renderCommands.length))
+        return false;
+
+    int32_t tile_count = renderer->tiles_x * renderer->tiles_y;
+    for (int32_t tile = 0; tile <= tile_count; ++tile)
+        renderer->tile_starts[tile] = 0;
+
+    PixelRect frame = { 0, 0, renderer->width, renderer->height };
+    PixelRect clip = frame;
+    ClipStack clips = { .clips = { frame } };
+    renderer->item_count = 0;
+    int32_t total = 0;
+
+    for (int idx = 0; idx < renderCommands.length; ++idx) {
+        Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(&renderCommands, idx);
+
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START) {
+            clip = clip_push(&clips, scissor_rect(renderer, renderCommand->boundingBox));
+            continue;
+        }
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+            clip = clip_pop(&clips);
+            continue;
+        }
+        if (
+            renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_CUSTOM
+            || renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_NONE
+        ) {
+            continue;
+        }
+
+        PixelRect rect = intersect(command_rect(renderer, renderCommand), clip);
+        if (rect.x1 <= rect.x0 || rect.y1 <= rect.y0)
+            continue;
+
+        SoftwareItem* item = &renderer->items[renderer->item_count++];
+        *item = (SoftwareItem) {
+            .command = renderCommand,
+            .clip = clip,
+            .tile_x0 = rect.x0 / TILE_SIZE,
+            .tile_y0 = rect.y0 / TILE_SIZE,
+            .tile_x1 = (rect.x1 - 1) / TILE_SIZE + 1,
+            .tile_y1 = (rect.y1 - 1) / TILE_SIZE + 1,
+        };
+
+        for (int ty = item->tile_y0; ty < item->tile_y1; ++ty) {
+            for (int tx = item->tile_x0; tx < item->tile_x1; ++tx)
+                renderer->tile_starts[ty * renderer->tiles_x + tx + 1] += 1;
+        }
+        total += (item->tile_x1 - item->tile_x0) * (item->tile_y1 - item->tile_y0);
+    }
+
+    if (!reserve_tile_items(renderer, total))
+        return false;
+
+    for (int32_t tile = 0; tile < tile_count; ++tile)
+        renderer->tile_starts[tile + 1] += renderer->tile_starts[tile];
+
+    // tile_starts[t + 1] doubles as the write cursor of tile t, ending up at its end
+    for (int32_t idx = 0; idx < renderer->item_count; ++idx) {
+        const SoftwareItem* item = &renderer->items[idx];
+        for (int ty = item->tile_y0; ty < item->tile_y1; ++ty) {
+            for (int tx = item->tile_x0; tx < item->tile_x1; ++tx) {
+                int32_t tile = ty * renderer->tiles_x + tx;
+                renderer->tile_items[renderer->tile_starts[tile]++] = idx;
+            }
+        }
+    }
+
+    // Shift the cursors back so tile_starts[t] is where tile t begins again
+    for (int32_t tile = tile_count; tile > 0; --tile)
+        renderer->tile_starts[tile] = renderer->tile_starts[tile - 1];
+    renderer->tile_starts[0] = 0;
+
+    return true;
+}
+
+static void render_tile(void* context, int32_t tile) {
+    Clay_Software_Renderer* renderer = (Clay_Software_Renderer*) context;
+
+    int tx = tile % renderer->tiles_x;
+    int ty = tile / renderer->tiles_x;
+    PixelRect bounds = {
+        .x0 = tx * TILE_SIZE,
+        .y0 = ty * TILE_SIZE,
+        .x1 = CLAY__MIN((tx + 1) * TILE_SIZE, renderer->width),
+        .y1 = CLAY__MIN((ty + 1) * TILE_SIZE, renderer->height),
+    };
+
+    // Tiles only write their own pixels, which is all the synchronization there is
+    clear_rect(renderer, bounds);
+
+    SoftwareTarget target = { .pixels = renderer->pixels, .width = renderer->width };
+    for (int32_t idx = renderer->tile_starts[tile]; idx < renderer->tile_starts[tile + 1]; ++idx) {
+        const SoftwareItem* item = &renderer->items[renderer->tile_items[idx]];
+        target.clip = intersect(bounds, item->clip);
+        render_command(renderer, &target, item->command);
+    }
+}
+
+Clay_Software_Renderer* Clay_Software_Initialize(int width, int height) {
+    Clay_Software_Renderer* renderer = (Clay_Software_Renderer*) calloc(1, sizeof(Clay_Software_Renderer));
+    if (renderer == nullptr || !Clay_Software_Resize(renderer, width, height)) {
+        free(renderer);
+        return nullptr;
+    }
+
+    return renderer;
+}
+
+void Clay_Software_Close(Clay_Software_Renderer* renderer) {
+    for (int fdx = 0; fdx < renderer->font_count; ++fdx) {
+        SoftwareFont* font = &renderer->fonts[fdx];
+        UnloadFontData(font->metrics.font.glyphs, font->metrics.font.glyphCount);
+        free(font->metrics.font.recs);
+        font_metrics_free(&font->metrics);
+        free(font->coverage);
+    }
+
+    if (renderer->pool_running)
+        thread_pool_free(&renderer->pool);
+
+    free(renderer->items);
+    free(renderer->tile_starts);
+    free(renderer->tile_items);
+    free(renderer->pixels);
+    free(renderer);
+}
+
+bool Clay_Software_Resize(Clay_Software_Renderer* renderer, int width, int height) {
+    int tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    int tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    // Both buffers are swapped in together, so a failure leaves the old size fully usable
+    Color* pixels = (Color*) malloc(sizeof(Color) * (size_t) width * (size_t) height);
+    int32_t* tile_starts = (int32_t*) malloc(sizeof(int32_t) * (size_t) (tiles_x * tiles_y + 1));
+    if (pixels == nullptr || tile_starts == nullptr) {
+        free(pixels);
+        free(tile_starts);
+        return false;
+    }
+
+    free(renderer->pixels);
+    free(renderer->tile_starts);
+    renderer->pixels = pixels;
+    renderer->tile_starts = tile_starts;
+
+    renderer->width = width;
+    renderer->height = height;
+    renderer->tiles_x = tiles_x;
+    renderer->tiles_y = tiles_y;
+    return true;
+}
+
+int Clay_Software_SetThreadCount(Clay_Software_Renderer* renderer, int thread_count) {
+    if (renderer->pool_running) {
+        thread_pool_free(&renderer->pool);
+        renderer->pool_running = false;
+    }
+
+    if (thread_count <= 0)
+        thread_count = thread_pool_processor_count();
+    if (thread_count == 1)
+        return 1;
+
+    renderer->pool_running = thread_pool_init(&renderer->pool, thread_count);
+    return renderer->pool_running ? renderer->pool.thread_count : 1;
+}
+
+void Clay_Software_Render(
+    Clay_Software_Renderer* renderer,
+    Clay_RenderCommandArray renderCommands,
+    Color background
+) {
+    renderer->background = background;
+
+    // Binning only pays off when there are threads to hand the tiles to
+    TRACE_BEGIN("bin");
+    bool tiled = renderer->pool_running
+        && renderer->pool.thread_count > 1
+        && bin_commands(renderer, renderCommands);
+    TRACE_END();
+    if (!tiled) {
+        render_whole_frame(renderer, renderCommands);
+        return;
+    }
+
+    thread_pool_run(&renderer->pool, renderer->tiles_x * renderer->tiles_y, render_tile, renderer);
+}
+
+int32_t Clay_Software_AddFont(Clay_Software_Renderer* renderer, const char* path, int font_size) {
+    if (renderer->font_count == MAX_FONTS)
+        return -1;
+
+    int file_size = 0;
+    unsigned char* file_data = LoadFileData(path, &file_size);
+    if (file_data == nullptr)
+        return -1;
+
+    // Everything here stays on the CPU, raylib only needs a context for textures
+    constexpr int GLYPH_COUNT = 95;
+    Font font = { .baseSize = font_size, .glyphCount = GLYPH_COUNT };
+    font.glyphs = LoadFontData(file_data, file_size, font_size, nullptr, 0, FONT_DEFAULT);
+    UnloadFileData(file_data);
+    if (font.glyphs == nullptr)
+        return -1;
+
+    Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, font.glyphCount, font_size, 0, 0);
+    SoftwareFont* slot = &renderer->fonts[renderer->font_count];
+    *slot = (SoftwareFont) {
+        .coverage = (uint8_t*) malloc((size_t) atlas.width * (size_t) atlas.height),
+        .atlas_width = atlas.width,
+    };
+
+    if (slot->coverage == nullptr || atlas.format != PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) {
+        free(slot->coverage);
+        UnloadImage(atlas);
+        UnloadFontData(font.glyphs, font.glyphCount);
+        free(font.recs);
+        return -1;
+    }
+
+    // The atlas is gray + alpha with coverage in the alpha byte
+    const uint8_t* texels = (const uint8_t*) atlas.data;
+    for (ptrdiff_t idx = 0; idx < (ptrdiff_t) atlas.width * atlas.height; ++idx)
+        slot->coverage[idx] = texels[idx * 2 + 1];
+    UnloadImage(atlas);
+
+    if (!font_metrics_init(&slot->metrics, font)) {
+        free(slot->coverage);
+        UnloadFontData(font.glyphs, font.glyphCount);
+        free(font.recs);
+        return -1;
+    }
+
+    return renderer->font_count++;
+}
+
+const Color* Clay_Software_Pixels(const Clay_Software_Renderer* renderer, int* width, int* height) {
+    *width = renderer->width;
+    *height = renderer->height;
+    return renderer->pixels;
+}
+
+bool Clay_Software_SaveImage(const Clay_Software_Renderer* renderer, const char* path) {
+    Image image = {
+        .data = renderer->pixels,
+        .width = renderer->width,
+        .height = renderer->height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+    };
+    return ExportImage(image, path);
+}
+
+
+Clay_Dimensions Clay_Software_MeasureText(
+    Clay_StringSlice text,
+    Clay_TextElementConfig *cfg,
+    void *userData
+) {
+    const Clay_Software_Renderer* renderer = (const Clay_Software_Renderer*) userData;
+    const FontMetrics* metrics = renderer->font_count > 0
+        ? &renderer->fonts[cfg->fontId < renderer->font_count ? cfg->fontId : 0].metrics
+        : nullptr;
+
+    float maxTextWidth = 0.0f;
+    const char* line = text.chars;
+    const char* end = text.chars + text.length;
+    while (text.length > 0) {
+        const char* newline = memchr(line, '\n', (size_t) (end - line));
+        const char* lineEnd = newline != nullptr ? newline : end;
+
+        int32_t lineCharCount;
+        float lineTextWidth;
+        if (metrics != nullptr) {
+            lineTextWidth = font_metrics_line_width(metrics, line, (int32_t) (lineEnd - line), &lineCharCount)
+                * ((float) cfg->fontSize / (float) metrics->font.baseSize);
+        } else {
+            // No font to draw with, lay out as if every glyph were half an em wide
+            lineCharCount = (int32_t) (lineEnd - line);
+            lineTextWidth = (float) lineCharCount * (float) cfg->fontSize / 2;
+        }
+        lineTextWidth += (float) (lineCharCount * cfg->letterSpacing);
+        maxTextWidth = fmaxf(maxTextWidth, lineTextWidth);
+
+        if (newline == nullptr)
+            break;
+        line = newline + 1;
+    }
+
+    return (Clay_Dimensions) {
+        .width = maxTextWidth,
+        .height = cfg->fontSize,
+    };
+}
+
+Clay_Dimensions Clay_Software_MeasureTextBatch(
+    Clay_StringSlice text,
+    Clay_MeasureTextWord *words,
+    int32_t wordCount,
+    Clay_TextElementConfig *cfg,
+    void *userData
+) {
+    const Clay_Software_Renderer* renderer = (const Clay_Software_Renderer*) userData;
+    const FontMetrics* metrics = renderer->font_count > 0
+        ? &renderer->fonts[cfg->fontId < renderer->font_count ? cfg->fontId : 0].metrics
+        : nullptr;
+
+    if (metrics == nullptr) {
+        float glyphWidth = (float) cfg->fontSize / 2;
+        for (int32_t idx = 0; idx < wordCount; ++idx)
+            words[idx].width = (float) words[idx].length * glyphWidth + (float) (words[idx].length * cfg->letterSpacing);
+
+        return (Clay_Dimensions) {
+            .width = glyphWidth + (float) cfg->letterSpacing,
+            .height = cfg->fontSize,
+        };
+    }
+
+    float scaleFactor = (float) cfg->fontSize / (float) metrics->font.baseSize;
+    font_metrics_measure_words(metrics, text.chars, words, wordCount, scaleFactor, cfg->letterSpacing);
+    return (Clay_Dimensions) {
+        .width = metrics->ascii_advance[' '] * scaleFactor + (float) cfg->letterSpacing,
+        .height = cfg->fontSize,
+    };
+}
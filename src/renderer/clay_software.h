@@ -0,0 +1,55 @@
+#pragma once
+
+#include "clay.h"
+#include "raylib.h"
+
+#include <stdint.h>
+
+
+// CPU rasterizer for Clay render commands, drawing into an in-memory RGBA framebuffer.
+// Needs neither a window nor a GPU, only raylib's CPU side image and font loading.
+typedef struct Clay_Software_Renderer Clay_Software_Renderer;
+
+
+// nullptr if the framebuffer can't be allocated
+Clay_Software_Renderer* Clay_Software_Initialize(int width, int height);
+void Clay_Software_Close(Clay_Software_Renderer* renderer);
+
+// Keeps nothing of the old contents
+bool Clay_Software_Resize(Clay_Software_Renderer* renderer, int width, int height);
+
+// Rasterizes frames as 64x64 tiles spread over `thread_count` threads, 0 for one per
+// processor. With 1, the default, frames are drawn in one pass on the calling thread.
+// Output is the same for every thread count. Returns the thread count actually in use.
+int Clay_Software_SetThreadCount(Clay_Software_Renderer* renderer, int thread_count);
+
+// Clears to `background` and draws the commands. Images are GPU textures, which this
+// renderer can't read, so they show up as flat boxes of their tint, or gray if untinted.
+// Custom commands are skipped.
+void Clay_Software_Render(
+    Clay_Software_Renderer* renderer,
+    Clay_RenderCommandArray renderCommands,
+    Color background
+);
+
+// Rasterizes a font file into a coverage atlas at `font_size` pixels and returns its fontId,
+// or -1 if it can't be loaded. Ids are handed out from 0 in the order fonts are added.
+// Text with an unknown fontId uses font 0, text with no fonts at all isn't drawn.
+int32_t Clay_Software_AddFont(Clay_Software_Renderer* renderer, const char* path, int font_size);
+
+// RGBA8, `width * height` pixels, rows top to bottom
+const Color* Clay_Software_Pixels(const Clay_Software_Renderer* renderer, int* width, int* height);
+
+// Any format raylib's ExportImage() supports, picked by extension
+bool Clay_Software_SaveImage(const Clay_Software_Renderer* renderer, const char* path);
+
+// userData must be the Clay_Software_Renderer the text will be drawn with
+Clay_Dimensions Clay_Software_MeasureText(Clay_StringSlice text, Clay_TextElementConfig* config, void* userData);
+// Clay_Software_MeasureText for all words of a string in one call, see Clay_SetMeasureTextBatchFunction()
+Clay_Dimensions Clay_Software_MeasureTextBatch(
+    Clay_StringSlice text,
+    Clay_MeasureTextWord* words,
+    int32_t wordCount,
+    Clay_TextElementConfig* config,
+    void* userData
+);
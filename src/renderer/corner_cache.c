@@ -0,0 +1,136 @@
+#include "corner_cache.h"
+
+#include "raylib.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Power of two, kept at most half full
+constexpr int32_t MAX_ENTRIES = 512;
+constexpr int32_t MAX_POINTS = 1 << 15;
+
+// Caps a single corner so it always fits in the pool. Only radii in the thousands of
+// pixels would get this many segments anyway.
+constexpr int MAX_SEGMENTS = 255;
+
+
+// Arc subdivision with the same error bound raylib uses for DrawRectangleRounded(segments = 0)
+static int corner_segments(float radius) {
+    constexpr float SMOOTH_CIRCLE_ERROR_RATE = 0.5f;
+    if (radius <= 1)
+        return 1;
+
+    float theta = acosf(2 * powf(1 - SMOOTH_CIRCLE_ERROR_RATE / radius, 2) - 1);
+    int segments = (int) ceilf(2 * PI / theta / 4);
+    return segments < 1 ? 1 : segments > MAX_SEGMENTS ? MAX_SEGMENTS : segments;
+}
+
+static uint32_t hash_corner(float radius, float width, int segments) {
+    uint32_t radius_bits;
+    uint32_t width_bits;
+    memcpy(&radius_bits, &radius, sizeof(radius_bits));
+    memcpy(&width_bits, &width, sizeof(width_bits));
+
+    uint32_t hash = radius_bits * 0x9E3779B1u;
+    hash = (hash ^ width_bits) * 0x85EBCA77u;
+    hash = (hash ^ (uint32_t) segments) * 0xC2B2AE3Du;
+    return hash ^ (hash >> 16);
+}
+
+static void corner_cache_clear(CornerCache* cache) {
+    for (int32_t idx = 0; idx < MAX_ENTRIES; ++idx)
+        cache->entries[idx].first_point = -1;
+
+    cache->entry_count = 0;
+    cache->point_count = 0;
+}
+
+static CornerMesh entry_mesh(const CornerCache* cache, const CornerCacheEntry* entry) {
+    const Vector2* outer = cache->points + entry->first_point;
+    return (CornerMesh) {
+        .segments = entry->segments,
+        .outer = outer,
+        .inner = entry->width > 0 ? outer + entry->segments + 1 : nullptr,
+    };
+}
+
+
+bool corner_cache_init(CornerCache* cache) {
+    *cache = (CornerCache) {};
+
+    cache->entries = (CornerCacheEntry*) malloc(sizeof(CornerCacheEntry) * (size_t) MAX_ENTRIES);
+    cache->points = (Vector2*) malloc(sizeof(Vector2) * (size_t) MAX_POINTS);
+    if (cache->entries == nullptr || cache->points == nullptr) {
+        corner_cache_free(cache);
+        return false;
+    }
+
+    corner_cache_clear(cache);
+    return true;
+}
+
+void corner_cache_free(CornerCache* cache) {
+    free(cache->entries);
+    free(cache->points);
+    *cache = (CornerCache) {};
+}
+
+
+void corner_cache_reserve(CornerCache* cache, int corners) {
+    // Rings at the most segments, whatever the corners turn out to be
+    int32_t most_points = corners * (MAX_SEGMENTS + 1) * 2;
+    if (cache->entry_count + corners > MAX_ENTRIES / 2 || cache->point_count + most_points > MAX_POINTS)
+        corner_cache_clear(cache);
+}
+
+CornerMesh corner_cache_get(CornerCache* cache, float radius, float width) {
+    int segments = corner_segments(radius);
+    int32_t point_count = (segments + 1) * (width > 0 ? 2 : 1);
+
+    // Radii come from rounded layout values, so exact comparisons hit reliably
+    uint32_t mask = (uint32_t) (MAX_ENTRIES - 1);
+    uint32_t slot = hash_corner(radius, width, segments) & mask;
+    for (;; slot = (slot + 1) & mask) {
+        CornerCacheEntry* entry = &cache->entries[slot];
+        if (entry->first_point == -1)
+            break;
+
+        if (
+            memcmp(&entry->radius, &radius, sizeof(radius)) == 0
+            && memcmp(&entry->width, &width, sizeof(width)) == 0
+            && entry->segments == segments
+        ) {
+            return entry_mesh(cache, entry);
+        }
+    }
+
+    CornerCacheEntry* entry = &cache->entries[slot];
+    *entry = (CornerCacheEntry) {
+        .radius = radius,
+        .width = width,
+        .segments = segments,
+        .first_point = cache->point_count,
+    };
+
+    Vector2* outer = cache->points + cache->point_count;
+    Vector2* inner = outer + segments + 1;
+    float inner_radius = roundf(radius - width);
+
+    float step = (PI / 2) / (float) segments;
+    for (int sdx = 0; sdx <= segments; ++sdx) {
+        float angle = step * (float) sdx;
+        float c = cosf(angle);
+        float s = sinf(angle);
+
+        outer[sdx] = (Vector2) { c * radius, s * radius };
+        if (width > 0)
+            inner[sdx] = (Vector2) { c * inner_radius, s * inner_radius };
+    }
+
+    cache->entry_count += 1;
+    cache->point_count += point_count;
+    return entry_mesh(cache, entry);
+}
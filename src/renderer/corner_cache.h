@@ -0,0 +1,48 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdint.h>
+
+
+// Tessellated quarter circle of a rounded corner, relative to the center of its arc.
+// Points start pointing right and go clockwise on screen through a quarter turn, other
+// corners are the same points rotated by whole quarter turns, which needs no trig.
+typedef struct CornerMesh {
+    int segments;
+    // segments + 1 points on the arc of the corner radius
+    const Vector2* outer;
+    // segments + 1 points on the arc `width` inside it, nullptr for filled corners
+    const Vector2* inner;
+} CornerMesh;
+
+typedef struct CornerCacheEntry {
+    float radius;
+    float width;
+    int segments;
+    // Offset of the outer points in the pool, the inner ones follow them. -1 when empty.
+    int32_t first_point;
+} CornerCacheEntry;
+
+// Corner meshes keyed by (radius, border width, segment count). UIs only ever use a
+// handful of radii, so sin/cos run once per distinct corner instead of every frame.
+// When the cache fills up it starts over rather than evicting piecemeal, which only ever
+// happens in corner_cache_reserve(), so meshes stay valid until the next reserve.
+typedef struct CornerCache {
+    CornerCacheEntry* entries;
+    int32_t entry_count;
+
+    Vector2* points;
+    int32_t point_count;
+} CornerCache;
+
+
+bool corner_cache_init(CornerCache* cache);
+void corner_cache_free(CornerCache* cache);
+
+// Makes room for `corners` more meshes, starting over if they might not fit. Call it before
+// fetching the meshes of a shape, meshes fetched before it are invalid afterwards.
+void corner_cache_reserve(CornerCache* cache, int corners);
+
+// Filled corner when width is 0, a ring of that thickness otherwise. Needs room reserved.
+CornerMesh corner_cache_get(CornerCache* cache, float radius, float width);
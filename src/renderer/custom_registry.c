@@ -0,0 +1,167 @@
+#include "custom_registry.h"
+
+#include "clay.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+constexpr uint32_t INITIAL_CAPACITY = 16;
+
+
+static uint32_t hash_tag(uint32_t tag) {
+    return tag * 0x9E3779B1u;
+}
+
+static uint32_t find_slot(const CustomRegistry* registry, uint32_t tag) {
+    uint32_t mask = registry->capacity - 1;
+    uint32_t slot = hash_tag(tag) & mask;
+    while (registry->tags[slot] != 0 && registry->tags[slot] != tag)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+static bool grow(CustomRegistry* registry) {
+    uint32_t capacity = registry->capacity == 0 ? INITIAL_CAPACITY : registry->capacity * 2;
+    uint32_t* tags = (uint32_t*) calloc(capacity, sizeof(uint32_t));
+    CustomHandler* handlers = (CustomHandler*) calloc(capacity, sizeof(CustomHandler));
+    uint32_t* starts = (uint32_t*) calloc(capacity + 1, sizeof(uint32_t));
+    if (tags == nullptr || handlers == nullptr || starts == nullptr) {
+        free(tags);
+        free(handlers);
+        free(starts);
+        return false;
+    }
+
+    CustomRegistry grown = {
+        .tags = tags,
+        .handlers = handlers,
+        .capacity = capacity,
+        .count = registry->count,
+        .frame_commands = registry->frame_commands,
+        .frame_capacity = registry->frame_capacity,
+        .frame_starts = starts,
+    };
+    for (uint32_t slot = 0; slot < registry->capacity; ++slot) {
+        if (registry->tags[slot] == 0)
+            continue;
+
+        uint32_t target = find_slot(&grown, registry->tags[slot]);
+        tags[target] = registry->tags[slot];
+        handlers[target] = registry->handlers[slot];
+    }
+
+    free(registry->tags);
+    free(registry->handlers);
+    free(registry->frame_starts);
+    *registry = grown;
+    return true;
+}
+
+
+void custom_registry_init(CustomRegistry* registry) {
+    *registry = (CustomRegistry) {};
+}
+
+void custom_registry_free(CustomRegistry* registry) {
+    free(registry->tags);
+    free(registry->handlers);
+    free(registry->frame_commands);
+    free(registry->frame_starts);
+    *registry = (CustomRegistry) {};
+}
+
+bool custom_registry_add(CustomRegistry* registry, uint32_t tag, CustomHandler handler) {
+    if (tag == 0 || handler.draw == nullptr)
+        return false;
+
+    if ((registry->count + 1) * 2 > registry->capacity && !grow(registry))
+        return false;
+
+    uint32_t slot = find_slot(registry, tag);
+    if (registry->tags[slot] == 0)
+        registry->count += 1;
+
+    registry->tags[slot] = tag;
+    registry->handlers[slot] = handler;
+    return true;
+}
+
+const CustomHandler* custom_registry_find(const CustomRegistry* registry, const void* customData) {
+    if (customData == nullptr || registry->count == 0)
+        return nullptr;
+
+    uint32_t tag = *(const uint32_t*) customData;
+    if (tag == 0)
+        return nullptr;
+
+    uint32_t slot = find_slot(registry, tag);
+    return registry->tags[slot] != 0 ? &registry->handlers[slot] : nullptr;
+}
+
+void custom_registry_prepare(CustomRegistry* registry, Clay_RenderCommandArray renderCommands) {
+    registry->animating = false;
+    if (registry->count == 0)
+        return;
+
+    // Counting sort by slot, so every prepare step gets its commands in one contiguous run
+    uint32_t* starts = registry->frame_starts;
+    for (uint32_t slot = 0; slot <= registry->capacity; ++slot)
+        starts[slot] = 0;
+
+    uint32_t total = 0;
+    for (int32_t idx = 0; idx < renderCommands.length; ++idx) {
+        Clay_RenderCommand* renderCommand = &renderCommands.internalArray[idx];
+        if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_CUSTOM)
+            continue;
+
+        const CustomHandler* handler = custom_registry_find(registry, renderCommand->renderData.custom.customData);
+        if (handler == nullptr || handler->prepare == nullptr)
+            continue;
+
+        starts[handler - registry->handlers + 1] += 1;
+        total += 1;
+    }
+    if (total == 0)
+        return;
+
+    if (total > registry->frame_capacity) {
+        Clay_RenderCommand** commands = (Clay_RenderCommand**) realloc(
+            registry->frame_commands,
+            sizeof(Clay_RenderCommand*) * total
+        );
+        // Skipping the prepare steps beats failing the frame
+        if (commands == nullptr)
+            return;
+
+        registry->frame_commands = commands;
+        registry->frame_capacity = total;
+    }
+
+    for (uint32_t slot = 0; slot < registry->capacity; ++slot)
+        starts[slot + 1] += starts[slot];
+
+    // Fills each run from its start, leaving starts[slot] at the end of the run
+    for (int32_t idx = 0; idx < renderCommands.length; ++idx) {
+        Clay_RenderCommand* renderCommand = &renderCommands.internalArray[idx];
+        if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_CUSTOM)
+            continue;
+
+        const CustomHandler* handler = custom_registry_find(registry, renderCommand->renderData.custom.customData);
+        if (handler == nullptr || handler->prepare == nullptr)
+            continue;
+
+        registry->frame_commands[starts[handler - registry->handlers]++] = renderCommand;
+    }
+
+    uint32_t begin = 0;
+    for (uint32_t slot = 0; slot < registry->capacity; ++slot) {
+        uint32_t end = starts[slot];
+        if (end > begin) {
+            const CustomHandler* handler = &registry->handlers[slot];
+            registry->animating |= handler->prepare(handler->context, registry->frame_commands + begin, (int32_t) (end - begin));
+        }
+        begin = end;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "clay.h"
+#include "render_batch.h"
+
+#include <stdint.h>
+
+
+// Called once a frame before anything is drawn, with every custom command of the handler's
+// tag in draw order. Nothing is being drawn yet, so this may switch render targets to
+// update textures, advance animations and such. Returns true while the elements are
+// animating, the app then keeps presenting frames even if nothing else changes.
+typedef bool (*CustomPrepareFunction)(void* context, Clay_RenderCommand* const* commands, int32_t count);
+
+// Draws one element by pushing geometry into `batch`, the same batch rectangles, images and
+// text go into, so consecutive custom elements share draw calls with them. The bounding box
+// is already rounded to whole pixels. Must not flush the batch or draw through raylib.
+typedef void (*CustomDrawFunction)(
+    void* context,
+    RenderBatch* batch,
+    Clay_BoundingBox boundingBox,
+    Clay_CustomRenderData* data
+);
+
+typedef struct CustomHandler {
+    // Optional
+    CustomPrepareFunction prepare;
+    CustomDrawFunction draw;
+    void* context;
+} CustomHandler;
+
+// Handlers for custom elements addressed by tag. The customData of a custom element must
+// point at a struct whose first member is its nonzero uint32_t tag, the rest is up to
+// the handler. Elements with unknown tags or without customData are skipped.
+//
+// Frames only count as changed when a customData pointer or config does, animations have
+// to report themselves from their prepare step. Layers don't notice them either, keep
+// animated elements out of retained layers.
+typedef struct CustomRegistry {
+    // Open addressing by tag, 0 marks a free slot
+    uint32_t* tags;
+    CustomHandler* handlers;
+    uint32_t capacity;
+    uint32_t count;
+
+    // This frame's commands grouped by slot, for the prepare steps
+    Clay_RenderCommand** frame_commands;
+    uint32_t frame_capacity;
+    // Indexed by slot, one past the end as well
+    uint32_t* frame_starts;
+
+    // Some prepare step of the last frame drawn reported an animation
+    bool animating;
+} CustomRegistry;
+
+
+void custom_registry_init(CustomRegistry* registry);
+void custom_registry_free(CustomRegistry* registry);
+
+// Registers or replaces the handler for `tag`. False when `tag` is 0, `handler` has no
+// draw function or it's out of memory.
+bool custom_registry_add(CustomRegistry* registry, uint32_t tag, CustomHandler handler);
+
+// Handler for the element `customData` points to, nullptr if there is none
+const CustomHandler* custom_registry_find(const CustomRegistry* registry, const void* customData);
+
+// Runs every prepare step with this frame's commands of its tag and collects whether any
+// of them is animating
+void custom_registry_prepare(CustomRegistry* registry, Clay_RenderCommandArray renderCommands);
@@ -0,0 +1,136 @@
+#include "draw_list.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+[[gnu::always_inline]]
+static inline bool overlaps(DrawRect a, DrawRect b) {
+    return a.x < b.x + b.width
+        && b.x < a.x + a.width
+        && a.y < b.y + b.height
+        && b.y < a.y + a.height;
+}
+
+static DrawRect merge(DrawRect a, DrawRect b) {
+    int32_t left = a.x < b.x ? a.x : b.x;
+    int32_t top = a.y < b.y ? a.y : b.y;
+    int32_t right = a.x + a.width > b.x + b.width ? a.x + a.width : b.x + b.width;
+    int32_t bottom = a.y + a.height > b.y + b.height ? a.y + a.height : b.y + b.height;
+    return (DrawRect) { left, top, right - left, bottom - top };
+}
+
+static bool resize(void** array, int32_t capacity, size_t element_size) {
+    void* resized = realloc(*array, element_size * (size_t) capacity);
+    if (resized == nullptr)
+        return false;
+
+    *array = resized;
+    return true;
+}
+
+// Sorts the commands in [begin, end) into batches and writes them out from `position`.
+// A command joins the latest batch with its key unless something in a batch after that
+// one overlaps it, drawing it earlier would then change what ends up on top.
+static int32_t sort_group(DrawList* list, int32_t begin, int32_t end, int32_t position) {
+    DrawBatch* batches = list->batches;
+    int32_t batch_count = 0;
+
+    for (int32_t command = begin; command < end; ++command) {
+        uint32_t key = list->keys[command];
+        DrawRect bounds = list->bounds[command];
+        list->next[command] = -1;
+
+        int32_t target = -1;
+        int32_t oldest = batch_count > DRAW_LIST_LOOKBACK ? batch_count - DRAW_LIST_LOOKBACK : 0;
+        for (int32_t bdx = batch_count - 1; key != DRAW_KEY_ALONE && bdx >= oldest; --bdx) {
+            if (batches[bdx].key == key) {
+                target = bdx;
+                break;
+            }
+            if (overlaps(batches[bdx].bounds, bounds))
+                break;
+        }
+
+        if (target < 0) {
+            batches[batch_count++] = (DrawBatch) { key, bounds, command, command };
+            continue;
+        }
+
+        DrawBatch* batch = &batches[target];
+        list->next[batch->last] = command;
+        batch->last = command;
+        batch->bounds = merge(batch->bounds, bounds);
+    }
+
+    for (int32_t bdx = 0; bdx < batch_count; ++bdx) {
+        for (int32_t command = batches[bdx].first; command >= 0; command = list->next[command])
+            list->order[position++] = command;
+    }
+
+    return position;
+}
+
+
+void draw_list_free(DrawList* list) {
+    free(list->rects);
+    free(list->bounds);
+    free(list->colors);
+    free(list->keys);
+    free(list->z_indices);
+    free(list->order);
+    free(list->next);
+    free(list->batches);
+    *list = (DrawList) {};
+}
+
+bool draw_list_reserve(DrawList* list, int32_t count) {
+    if (count > list->capacity) {
+        // Arrays that grew before one failed just stay larger, the capacity is what counts
+        int32_t capacity = list->capacity * 2 > count ? list->capacity * 2 : count;
+        bool grown = resize((void**) &list->rects, capacity, sizeof(DrawRect))
+            && resize((void**) &list->bounds, capacity, sizeof(DrawRect))
+            && resize((void**) &list->colors, capacity, sizeof(Color))
+            && resize((void**) &list->keys, capacity, sizeof(uint32_t))
+            && resize((void**) &list->z_indices, capacity, sizeof(int16_t))
+            && resize((void**) &list->order, capacity, sizeof(int32_t))
+            && resize((void**) &list->next, capacity, sizeof(int32_t))
+            && resize((void**) &list->batches, capacity, sizeof(DrawBatch));
+        if (!grown)
+            return false;
+
+        list->capacity = capacity;
+    }
+
+    list->count = count;
+    return true;
+}
+
+void draw_list_sort(DrawList* list) {
+    int32_t position = 0;
+    int32_t begin = 0;
+    while (begin < list->count) {
+        if (list->keys[begin] == DRAW_KEY_FIXED) {
+            list->order[position++] = begin++;
+            continue;
+        }
+
+        int32_t end = begin + 1;
+        while (
+            end < list->count
+            && list->keys[end] != DRAW_KEY_FIXED
+            && list->z_indices[end] == list->z_indices[begin]
+        ) {
+            end += 1;
+        }
+
+        position = sort_group(list, begin, end, position);
+        begin = end;
+    }
+}
+
+void draw_list_keep_order(DrawList* list) {
+    for (int32_t idx = 0; idx < list->count; ++idx)
+        list->order[idx] = idx;
+}
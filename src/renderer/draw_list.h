@@ -0,0 +1,70 @@
+#pragma once
+
+#include "clay.h"
+#include "raylib.h"
+
+#include <stdint.h>
+
+
+// Commands that stay where they are and that nothing moves across, scissors
+constexpr uint32_t DRAW_KEY_FIXED = 0;
+// Commands that never share a batch, though others may still move past them
+constexpr uint32_t DRAW_KEY_ALONE = 1;
+
+// Earlier batches of a group a command looks through for one with its key
+constexpr int DRAW_LIST_LOOKBACK = 16;
+
+// Pipeline state a command is drawn with. Commands with equal keys can share a draw call,
+// every key change between neighbours flushes a batch.
+[[gnu::always_inline]]
+static inline uint32_t draw_key(unsigned int texture_id, uint32_t pipeline) {
+    return ((texture_id + 1) << 2) | (pipeline & 3);
+}
+
+typedef struct DrawRect {
+    int32_t x, y, width, height;
+} DrawRect;
+
+// Run of commands with the same key drawn back to back
+typedef struct DrawBatch {
+    uint32_t key;
+    // Union of what its commands touch
+    DrawRect bounds;
+    int32_t first;
+    int32_t last;
+} DrawBatch;
+
+// A frame's render commands flattened for drawing, structure of arrays indexed by command.
+// The renderer fills in what commands look like, draw_list_sort() then decides the order.
+typedef struct DrawList {
+    // Bounding box rounded to whole pixels
+    DrawRect* rects;
+    // Everything the command may touch, for the overlap tests. Glyphs overhang their box.
+    DrawRect* bounds;
+    Color* colors;
+    uint32_t* keys;
+    int16_t* z_indices;
+
+    // Indexed by position, the command drawn there
+    int32_t* order;
+
+    int32_t count;
+    int32_t capacity;
+
+    // Sorting scratch, commands chain to the next one of their batch
+    int32_t* next;
+    DrawBatch* batches;
+} DrawList;
+
+
+void draw_list_free(DrawList* list);
+
+// Makes room for `count` commands and sets the count, false when out of memory
+bool draw_list_reserve(DrawList* list, int32_t count);
+
+// Groups commands of equal keys within each run of the same zIndex between fixed commands.
+// A command only moves ahead of commands it doesn't overlap, so the frame looks the same.
+void draw_list_sort(DrawList* list);
+
+// Order the commands came in, for drawing without sorting
+void draw_list_keep_order(DrawList* list);
@@ -0,0 +1,136 @@
+#include "fingerprint.h"
+
+#include "clay.h"
+
+#include <stdint.h>
+#include <string.h>
+
+
+constexpr uint64_t FINGERPRINT_SEED = 0x9e3779b97f4a7c15ull;
+
+
+[[gnu::always_inline]]
+static inline uint64_t mix(uint64_t hash, uint64_t value) {
+    hash ^= value + FINGERPRINT_SEED + (hash << 6) + (hash >> 2);
+    hash *= 0xff51afd7ed558ccdull;
+    return hash ^ (hash >> 32);
+}
+
+[[gnu::always_inline]]
+static inline uint64_t mix_float(uint64_t hash, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    return mix(hash, bits);
+}
+
+static uint64_t mix_bytes(uint64_t hash, const char* bytes, int32_t length) {
+    int32_t idx = 0;
+    for (; idx + 8 <= length; idx += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + idx, sizeof word);
+        hash = mix(hash, word);
+    }
+
+    uint64_t tail = 0;
+    if (idx < length)
+        memcpy(&tail, bytes + idx, (size_t) (length - idx));
+    return mix(hash, tail ^ (uint64_t) length);
+}
+
+static uint64_t mix_color(uint64_t hash, Clay_Color color) {
+    hash = mix_float(hash, color.r);
+    hash = mix_float(hash, color.g);
+    hash = mix_float(hash, color.b);
+    return mix_float(hash, color.a);
+}
+
+static uint64_t mix_radius(uint64_t hash, Clay_CornerRadius radius) {
+    hash = mix_float(hash, radius.topLeft);
+    hash = mix_float(hash, radius.topRight);
+    hash = mix_float(hash, radius.bottomLeft);
+    return mix_float(hash, radius.bottomRight);
+}
+
+
+uint64_t fingerprint_bytes(const char* bytes, int32_t length) {
+    return mix_bytes(FINGERPRINT_SEED, bytes, length);
+}
+
+uint64_t fingerprint_render_commands(const Clay_RenderCommand* commands, int32_t count) {
+    return fingerprint_render_commands_at(commands, count, (Clay_Vector2) { 0, 0 });
+}
+
+uint64_t fingerprint_render_commands_at(
+    const Clay_RenderCommand* commands,
+    int32_t count,
+    Clay_Vector2 origin
+) {
+    uint64_t hash = mix(FINGERPRINT_SEED, (uint64_t) count);
+
+    for (int32_t idx = 0; idx < count; ++idx) {
+        const Clay_RenderCommand* command = &commands[idx];
+
+        hash = mix(hash, command->id);
+        hash = mix(hash, ((uint64_t) command->commandType << 16) | (uint16_t) command->zIndex);
+        hash = mix(hash, (uintptr_t) command->userData);
+        hash = mix_float(hash, command->boundingBox.x - origin.x);
+        hash = mix_float(hash, command->boundingBox.y - origin.y);
+        hash = mix_float(hash, command->boundingBox.width);
+        hash = mix_float(hash, command->boundingBox.height);
+
+        const Clay_RenderData* data = &command->renderData;
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+                hash = mix_color(hash, data->rectangle.backgroundColor);
+                hash = mix_radius(hash, data->rectangle.cornerRadius);
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+                hash = mix_color(hash, data->border.color);
+                hash = mix_radius(hash, data->border.cornerRadius);
+                hash = mix(
+                    hash,
+                    (uint64_t) data->border.width.left
+                        | (uint64_t) data->border.width.right << 16
+                        | (uint64_t) data->border.width.top << 32
+                        | (uint64_t) data->border.width.bottom << 48
+                );
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_TEXT:
+                // The slice may point at a reused buffer, so hash the contents, not the pointer
+                hash = mix_bytes(hash, data->text.stringContents.chars, data->text.stringContents.length);
+                hash = mix_color(hash, data->text.textColor);
+                hash = mix(
+                    hash,
+                    (uint64_t) data->text.fontId
+                        | (uint64_t) data->text.fontSize << 16
+                        | (uint64_t) data->text.letterSpacing << 32
+                        | (uint64_t) data->text.lineHeight << 48
+                );
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+                hash = mix_color(hash, data->image.backgroundColor);
+                hash = mix_radius(hash, data->image.cornerRadius);
+                hash = mix(hash, (uintptr_t) data->image.imageData);
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+                hash = mix_color(hash, data->custom.backgroundColor);
+                hash = mix_radius(hash, data->custom.cornerRadius);
+                hash = mix(hash, (uintptr_t) data->custom.customData);
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+                hash = mix(hash, (uint64_t) data->clip.horizontal << 1 | (uint64_t) data->clip.vertical);
+                break;
+
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+            case CLAY_RENDER_COMMAND_TYPE_NONE:
+                break;
+        }
+    }
+
+    return hash;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "clay.h"
+
+#include <stdint.h>
+
+
+// Order-sensitive hash of everything that affects how the commands draw:
+// ids, bounding boxes, render data and the text they reference.
+// Equal fingerprints mean the commands would produce the same pixels.
+uint64_t fingerprint_render_commands(const Clay_RenderCommand* commands, int32_t count);
+
+// Same, with bounding boxes taken relative to `origin`. Commands that only moved
+// together keep their fingerprint.
+uint64_t fingerprint_render_commands_at(
+    const Clay_RenderCommand* commands,
+    int32_t count,
+    Clay_Vector2 origin
+);
+
+// Hash of a byte string, for keying caches on text contents
+uint64_t fingerprint_bytes(const char* bytes, int32_t length);
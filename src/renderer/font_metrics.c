@@ -0,0 +1,268 @@
+#include "font_metrics.h"
+
+#include "clay.h"
+#include "raylib.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+static bool is_ascii(const uint8_t* bytes, int32_t length) {
+    int32_t idx = 0;
+
+#if defined(__SSE2__)
+    __m128i high_bits = _mm_setzero_si128();
+    for (; idx + 16 <= length; idx += 16)
+        high_bits = _mm_or_si128(high_bits, _mm_loadu_si128((const __m128i*) (bytes + idx)));
+
+    if (_mm_movemask_epi8(high_bits) != 0)
+        return false;
+#endif
+
+    uint8_t tail = 0;
+    for (; idx < length; ++idx)
+        tail |= bytes[idx];
+
+    return tail < 0x80;
+}
+
+static float line_width_scalar(const float* advance, const uint8_t* bytes, int32_t length) {
+    // Independent accumulators so the adds don't serialize on one register
+    float sum[4] = { 0, 0, 0, 0 };
+
+    int32_t idx = 0;
+    for (; idx + 4 <= length; idx += 4) {
+        sum[0] += advance[bytes[idx]];
+        sum[1] += advance[bytes[idx + 1]];
+        sum[2] += advance[bytes[idx + 2]];
+        sum[3] += advance[bytes[idx + 3]];
+    }
+    for (; idx < length; ++idx)
+        sum[0] += advance[bytes[idx]];
+
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+
+static uint32_t hash_codepoint(int32_t codepoint) {
+    return (uint32_t) codepoint * 0x9E3779B1u;
+}
+
+static bool build_astral_table(FontMetrics* metrics) {
+    const Font* font = &metrics->font;
+
+    int32_t astral_count = 0;
+    for (int gdx = 0; gdx < font->glyphCount; ++gdx)
+        astral_count += font->glyphs[gdx].value > 0xFFFF;
+
+    if (astral_count == 0)
+        return true;
+
+    // Keep the load factor at or below one half
+    int32_t capacity = 16;
+    while (capacity < astral_count * 2)
+        capacity *= 2;
+
+    metrics->astral_codepoints = (int32_t*) malloc(sizeof(int32_t) * (size_t) capacity);
+    metrics->astral_glyphs = (uint16_t*) malloc(sizeof(uint16_t) * (size_t) capacity);
+    if (metrics->astral_codepoints == nullptr || metrics->astral_glyphs == nullptr)
+        return false;
+
+    metrics->astral_capacity = capacity;
+    for (int32_t idx = 0; idx < capacity; ++idx)
+        metrics->astral_codepoints[idx] = -1;
+
+    for (int gdx = font->glyphCount - 1; gdx >= 0; --gdx) {
+        int32_t codepoint = font->glyphs[gdx].value;
+        if (codepoint <= 0xFFFF)
+            continue;
+
+        // Walking glyphs backwards and overwriting keeps the first glyph for a codepoint
+        uint32_t slot = hash_codepoint(codepoint) & (uint32_t) (capacity - 1);
+        while (
+            metrics->astral_codepoints[slot] != -1
+            && metrics->astral_codepoints[slot] != codepoint
+        ) {
+            slot = (slot + 1) & (uint32_t) (capacity - 1);
+        }
+
+        metrics->astral_codepoints[slot] = codepoint;
+        metrics->astral_glyphs[slot] = (uint16_t) gdx;
+    }
+
+    return true;
+}
+
+static bool build_bmp_table(FontMetrics* metrics) {
+    const Font* font = &metrics->font;
+
+    bool used[256] = {};
+    int32_t page_count = 1;
+    for (int gdx = 0; gdx < font->glyphCount; ++gdx) {
+        int32_t codepoint = font->glyphs[gdx].value;
+        if (codepoint < 0 || codepoint > 0xFFFF || used[codepoint >> 8])
+            continue;
+
+        used[codepoint >> 8] = true;
+        page_count += 1;
+    }
+
+    metrics->bmp_storage = (uint16_t*) malloc(sizeof(uint16_t) * 256 * (size_t) page_count);
+    if (metrics->bmp_storage == nullptr)
+        return false;
+
+    for (int32_t idx = 0; idx < 256 * page_count; ++idx)
+        metrics->bmp_storage[idx] = metrics->fallback_glyph;
+
+    // Page zero of the storage is the shared fallback page
+    uint16_t* pages[256];
+    uint16_t* next_page = metrics->bmp_storage + 256;
+    for (int page = 0; page < 256; ++page) {
+        if (used[page]) {
+            pages[page] = next_page;
+            next_page += 256;
+        } else {
+            pages[page] = metrics->bmp_storage;
+        }
+    }
+
+    // Walking glyphs backwards and overwriting keeps the first glyph for a codepoint
+    for (int gdx = font->glyphCount - 1; gdx >= 0; --gdx) {
+        int32_t codepoint = font->glyphs[gdx].value;
+        if (codepoint < 0 || codepoint > 0xFFFF)
+            continue;
+
+        pages[codepoint >> 8][codepoint & 0xFF] = (uint16_t) gdx;
+    }
+
+    for (int page = 0; page < 256; ++page)
+        metrics->bmp_pages[page] = pages[page];
+
+    return true;
+}
+
+
+bool font_metrics_init(FontMetrics* metrics, Font font) {
+    *metrics = (FontMetrics) { .font = font };
+
+    for (int gdx = 0; gdx < font.glyphCount; ++gdx) {
+        if (font.glyphs[gdx].value == '?') {
+            metrics->fallback_glyph = (uint16_t) gdx;
+            break;
+        }
+    }
+
+    metrics->glyph_advance = (float*) malloc(sizeof(float) * (size_t) font.glyphCount);
+    if (metrics->glyph_advance == nullptr || !build_bmp_table(metrics) || !build_astral_table(metrics)) {
+        font_metrics_free(metrics);
+        return false;
+    }
+
+    for (int gdx = 0; gdx < font.glyphCount; ++gdx) {
+        if (font.glyphs[gdx].advanceX != 0)
+            metrics->glyph_advance[gdx] = (float) font.glyphs[gdx].advanceX;
+        else
+            metrics->glyph_advance[gdx] = font.recs[gdx].width + (float) font.glyphs[gdx].offsetX;
+    }
+
+    for (int32_t byte = 0; byte < 128; ++byte)
+        metrics->ascii_advance[byte] = metrics->glyph_advance[font_metrics_glyph_index(metrics, byte)];
+
+    return true;
+}
+
+void font_metrics_free(FontMetrics* metrics) {
+    free(metrics->glyph_advance);
+    free(metrics->bmp_storage);
+    free(metrics->astral_codepoints);
+    free(metrics->astral_glyphs);
+
+    *metrics = (FontMetrics) {};
+}
+
+
+int font_metrics_glyph_index(const FontMetrics* metrics, int32_t codepoint) {
+    if (codepoint >= 0 && codepoint <= 0xFFFF)
+        return metrics->bmp_pages[codepoint >> 8][codepoint & 0xFF];
+
+    if (metrics->astral_capacity == 0)
+        return metrics->fallback_glyph;
+
+    uint32_t mask = (uint32_t) (metrics->astral_capacity - 1);
+    for (uint32_t slot = hash_codepoint(codepoint) & mask;; slot = (slot + 1) & mask) {
+        if (metrics->astral_codepoints[slot] == codepoint)
+            return metrics->astral_glyphs[slot];
+        if (metrics->astral_codepoints[slot] == -1)
+            return metrics->fallback_glyph;
+    }
+}
+
+float font_metrics_line_width(
+    const FontMetrics* metrics,
+    const char* chars,
+    int32_t length,
+    int32_t* codepoint_count
+) {
+    const uint8_t* bytes = (const uint8_t*) chars;
+
+    if (is_ascii(bytes, length)) {
+        *codepoint_count = length;
+        return line_width_scalar(metrics->ascii_advance, bytes, length);
+    }
+
+    float width = 0;
+    int32_t count = 0;
+    for (int32_t idx = 0; idx < length; ++count) {
+        if (bytes[idx] < 0x80) {
+            width += metrics->ascii_advance[bytes[idx]];
+            idx += 1;
+            continue;
+        }
+
+        int32_t size;
+        int32_t codepoint = utf8_decode(chars + idx, length - idx, &size);
+        width += metrics->glyph_advance[font_metrics_glyph_index(metrics, codepoint)];
+        idx += size;
+    }
+
+    *codepoint_count = count;
+    return width;
+}
+
+void font_metrics_measure_words(
+    const FontMetrics* metrics,
+    const char* chars,
+    Clay_MeasureTextWord* words,
+    int32_t word_count,
+    float scale,
+    int32_t letter_spacing
+) {
+    const uint8_t* bytes = (const uint8_t*) chars;
+
+    // Words are a few bytes each, too short for the ASCII check and the unrolled sums to pay off
+    for (int32_t wdx = 0; wdx < word_count; ++wdx) {
+        Clay_MeasureTextWord* word = &words[wdx];
+        int32_t end = word->startOffset + word->length;
+
+        float width = 0;
+        int32_t count = 0;
+        for (int32_t idx = word->startOffset; idx < end; ++count) {
+            if (bytes[idx] < 0x80) {
+                width += metrics->ascii_advance[bytes[idx]];
+                idx += 1;
+                continue;
+            }
+
+            int32_t size;
+            int32_t codepoint = utf8_decode(chars + idx, end - idx, &size);
+            width += metrics->glyph_advance[font_metrics_glyph_index(metrics, codepoint)];
+            idx += size;
+        }
+
+        word->width = width * scale + (float) (count * letter_spacing);
+    }
+}
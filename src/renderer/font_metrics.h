@@ -0,0 +1,113 @@
+#pragma once
+
+#include "clay.h"
+#include "raylib.h"
+
+#include <stdint.h>
+
+
+// Glyph lookup and advances of a loaded font, precomputed so measuring a string is a table sum.
+// Measurement and drawing both resolve codepoints through here, so they always agree.
+typedef struct FontMetrics {
+    Font font;
+
+    // Unscaled advance per glyph index
+    float* glyph_advance;
+    // Unscaled advance per ASCII byte, the fast path for plain English text
+    float ascii_advance[128];
+
+    // BMP codepoint -> glyph index, split in 256 pages of 256 entries. Pages without any
+    // glyph all share one page of fallback entries, so a lookup is two loads and no branch.
+    const uint16_t* bmp_pages[256];
+    uint16_t* bmp_storage;
+
+    // Codepoints past the BMP (emoji mostly), open addressing with linear probing
+    int32_t* astral_codepoints;
+    uint16_t* astral_glyphs;
+    // Power of two, 0 when the font has no glyphs past the BMP
+    int32_t astral_capacity;
+
+    // Glyph drawn for codepoints the font lacks, '?' like raylib
+    uint16_t fallback_glyph;
+
+    // The atlas holds signed distances (FONT_SDF) instead of coverage, so it has to be
+    // drawn through the SDF shader but stays sharp at any size
+    bool sdf;
+} FontMetrics;
+
+
+bool font_metrics_init(FontMetrics* metrics, Font font);
+void font_metrics_free(FontMetrics* metrics);
+
+int font_metrics_glyph_index(const FontMetrics* metrics, int32_t codepoint);
+
+// Unscaled width of a single line of UTF-8, letter spacing not included.
+// Stores how many codepoints the line has, which is what letter spacing applies to.
+float font_metrics_line_width(
+    const FontMetrics* metrics,
+    const char* chars,
+    int32_t length,
+    int32_t* codepoint_count
+);
+
+// Widths of all the words Clay hands over for one string, walking it once in word order.
+// Each word gets its advances times `scale` plus `letter_spacing` per codepoint. Advances
+// are whole pixels, so this sums to what font_metrics_line_width() gives for the word.
+void font_metrics_measure_words(
+    const FontMetrics* metrics,
+    const char* chars,
+    Clay_MeasureTextWord* words,
+    int32_t word_count,
+    float scale,
+    int32_t letter_spacing
+);
+
+
+// Decodes the codepoint at the start of `chars`. Malformed or truncated sequences
+// decode as U+FFFD and consume a single byte, so decoding always makes progress.
+[[gnu::always_inline]]
+static inline int32_t utf8_decode(const char* chars, int32_t length, int32_t* size) {
+    const uint8_t* bytes = (const uint8_t*) chars;
+
+    if (bytes[0] < 0x80) {
+        *size = 1;
+        return bytes[0];
+    }
+
+    int32_t extra;
+    int32_t codepoint;
+    int32_t minimum;
+    if ((bytes[0] & 0xE0) == 0xC0) {
+        extra = 1;
+        codepoint = bytes[0] & 0x1F;
+        minimum = 0x80;
+    } else if ((bytes[0] & 0xF0) == 0xE0) {
+        extra = 2;
+        codepoint = bytes[0] & 0x0F;
+        minimum = 0x800;
+    } else if ((bytes[0] & 0xF8) == 0xF0) {
+        extra = 3;
+        codepoint = bytes[0] & 0x07;
+        minimum = 0x10000;
+    } else {
+        *size = 1;
+        return 0xFFFD;
+    }
+
+    *size = 1;
+    if (extra >= length)
+        return 0xFFFD;
+
+    for (int32_t idx = 1; idx <= extra; ++idx) {
+        if ((bytes[idx] & 0xC0) != 0x80)
+            return 0xFFFD;
+        codepoint = (codepoint << 6) | (bytes[idx] & 0x3F);
+    }
+
+    // Overlong encodings, surrogates and values past Unicode are all invalid
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        return 0xFFFD;
+
+    *size = extra + 1;
+    return codepoint;
+}
@@ -0,0 +1,177 @@
+#include "font_registry.h"
+
+#include "font_metrics.h"
+#include "raylib.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+const uint16_t FONT_SIZE_BUCKETS[FONT_SIZE_BUCKET_COUNT] = { 16, 24, 32, 48, 64, 96, 128 };
+
+
+static int size_bucket(uint16_t font_size) {
+    for (int bucket = 0; bucket < FONT_SIZE_BUCKET_COUNT - 1; ++bucket) {
+        if (font_size <= FONT_SIZE_BUCKETS[bucket])
+            return bucket;
+    }
+
+    return FONT_SIZE_BUCKET_COUNT - 1;
+}
+
+// LoadFontEx() only bakes coverage, distance fields go through the lower level calls
+static Font load_sdf_font(const FontSource* source) {
+    Font font = { .baseSize = FONT_SDF_BASE_SIZE };
+
+    int file_size = 0;
+    unsigned char* file_data = LoadFileData(source->path, &file_size);
+    if (file_data == nullptr)
+        return font;
+
+    // raylib falls back to printable ASCII when no codepoints are given
+    font.glyphCount = source->codepoints != nullptr ? source->codepoint_count : 95;
+    font.glyphs = LoadFontData(
+        file_data,
+        file_size,
+        FONT_SDF_BASE_SIZE,
+        source->codepoints,
+        source->codepoint_count,
+        FONT_SDF
+    );
+    UnloadFileData(file_data);
+    if (font.glyphs == nullptr)
+        return font;
+
+    // Glyph images already carry the distance field falloff as padding
+    Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, font.glyphCount, FONT_SDF_BASE_SIZE, 0, 1);
+    font.texture = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+
+    return font;
+}
+
+static size_t atlas_size(Font font) {
+    return (size_t) GetPixelDataSize(font.texture.width, font.texture.height, font.texture.format);
+}
+
+
+bool font_registry_init(FontRegistry* registry) {
+    *registry = (FontRegistry) {};
+
+    if (font_registry_add(registry, nullptr, nullptr, 0, FONT_BITMAP) != 0)
+        return false;
+
+    // The built-in font is already on the GPU, it only needs its lookup tables
+    FontSource* builtin = &registry->fonts[0];
+    Font font = GetFontDefault();
+    if (!font_metrics_init(&builtin->faces[0], font)) {
+        font_registry_free(registry);
+        return false;
+    }
+
+    builtin->states[0] = FONT_FACE_LOADED;
+    registry->atlas_bytes += atlas_size(font);
+    return true;
+}
+
+void font_registry_free(FontRegistry* registry) {
+    for (int32_t fdx = 0; fdx < registry->font_count; ++fdx) {
+        FontSource* source = &registry->fonts[fdx];
+
+        for (int bucket = 0; bucket < FONT_SIZE_BUCKET_COUNT; ++bucket) {
+            if (source->states[bucket] != FONT_FACE_LOADED)
+                continue;
+
+            // raylib owns the built-in font
+            if (source->path != nullptr)
+                UnloadFont(source->faces[bucket].font);
+            font_metrics_free(&source->faces[bucket]);
+        }
+    }
+
+    free(registry->fonts);
+    *registry = (FontRegistry) {};
+}
+
+
+int32_t font_registry_add(
+    FontRegistry* registry,
+    const char* path,
+    int* codepoints,
+    int codepoint_count,
+    FontType type
+) {
+    // Clay's fontId is 16 bits wide
+    if (registry->font_count > UINT16_MAX)
+        return -1;
+
+    if (registry->font_count == registry->font_capacity) {
+        int32_t capacity = registry->font_capacity == 0 ? 4 : registry->font_capacity * 2;
+
+        FontSource* fonts = (FontSource*) realloc(registry->fonts, sizeof(FontSource) * (size_t) capacity);
+        if (fonts == nullptr)
+            return -1;
+
+        registry->fonts = fonts;
+        registry->font_capacity = capacity;
+    }
+
+    registry->fonts[registry->font_count] = (FontSource) {
+        .path = path,
+        .type = type,
+        .codepoints = codepoints,
+        .codepoint_count = codepoint_count,
+    };
+
+    return registry->font_count++;
+}
+
+const FontMetrics* font_registry_get(FontRegistry* registry, uint16_t fontId, uint16_t font_size) {
+    const FontMetrics* builtin = &registry->fonts[0].faces[0];
+    if (fontId >= registry->font_count || registry->fonts[fontId].path == nullptr)
+        return builtin;
+
+    FontSource* source = &registry->fonts[fontId];
+    int bucket = source->type == FONT_SDF ? 0 : size_bucket(font_size);
+
+    switch (source->states[bucket]) {
+        case FONT_FACE_LOADED:
+            return &source->faces[bucket];
+        case FONT_FACE_FAILED:
+            return builtin;
+        case FONT_FACE_UNLOADED:
+            break;
+    }
+
+    Font font;
+    if (source->type == FONT_SDF) {
+        font = load_sdf_font(source);
+    } else {
+        // raylib hands back the built-in font when the file can't be loaded
+        font = LoadFontEx(source->path, FONT_SIZE_BUCKETS[bucket], source->codepoints, source->codepoint_count);
+        if (font.texture.id == GetFontDefault().texture.id)
+            font = (Font) {};
+    }
+
+    if (font.texture.id == 0) {
+        UnloadFont(font);
+        source->states[bucket] = FONT_FACE_FAILED;
+        return builtin;
+    }
+
+    if (!font_metrics_init(&source->faces[bucket], font)) {
+        UnloadFont(font);
+        source->states[bucket] = FONT_FACE_FAILED;
+        return builtin;
+    }
+
+    // Bitmap buckets mostly get drawn scaled down, point sampling would drop whole texel rows.
+    // Distance fields need interpolated samples to find the edge at all.
+    SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+    source->faces[bucket].sdf = source->type == FONT_SDF;
+
+    source->states[bucket] = FONT_FACE_LOADED;
+    registry->atlas_bytes += atlas_size(font);
+    return &source->faces[bucket];
+}
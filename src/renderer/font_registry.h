@@ -0,0 +1,69 @@
+#pragma once
+
+#include "font_metrics.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Pixel size SDF atlases are baked at. Distances interpolate well, so this one atlas
+// serves every font size, the base size only bounds how sharp corners stay.
+constexpr int FONT_SDF_BASE_SIZE = 64;
+
+// Pixel sizes bitmap glyph atlases are baked at. Text is scaled down from the smallest bucket
+// not below its font size, only sizes past the largest bucket get magnified.
+constexpr int FONT_SIZE_BUCKET_COUNT = 7;
+extern const uint16_t FONT_SIZE_BUCKETS[FONT_SIZE_BUCKET_COUNT];
+
+typedef enum FontFaceState {
+    FONT_FACE_UNLOADED = 0,
+    FONT_FACE_LOADED,
+    // Baking failed once, the built-in font stands in without trying again
+    FONT_FACE_FAILED,
+} FontFaceState;
+
+typedef struct FontSource {
+    // nullptr for raylib's built-in bitmap font, which only exists at one size
+    const char* path;
+    // FONT_SDF bakes one atlas for every size, FONT_BITMAP one per size bucket
+    FontType type;
+    // Codepoints baked into every atlas of this font, nullptr for printable ASCII
+    int* codepoints;
+    int codepoint_count;
+
+    // Indexed by size bucket, SDF fonts only use the first one
+    FontMetrics faces[FONT_SIZE_BUCKET_COUNT];
+    FontFaceState states[FONT_SIZE_BUCKET_COUNT];
+} FontSource;
+
+// Fonts addressed by Clay's fontId. Atlases are baked lazily the first time a
+// (fontId, size bucket) pair is measured or drawn and kept until the registry is freed.
+typedef struct FontRegistry {
+    // Indexed by fontId. Id 0 is the built-in font, the one Clay uses by default.
+    FontSource* fonts;
+    int32_t font_count;
+    int32_t font_capacity;
+
+    // Texture memory taken by every atlas baked so far
+    size_t atlas_bytes;
+} FontRegistry;
+
+
+bool font_registry_init(FontRegistry* registry);
+void font_registry_free(FontRegistry* registry);
+
+// Registers a font file as FONT_SDF or FONT_BITMAP and returns its fontId, or -1 when out
+// of memory. Both `path` and `codepoints` are borrowed and must outlive the registry.
+// Registering a font invalidates metrics previously returned by font_registry_get().
+int32_t font_registry_add(
+    FontRegistry* registry,
+    const char* path,
+    int* codepoints,
+    int codepoint_count,
+    FontType type
+);
+
+// Metrics of the atlas `fontId` is drawn from at `font_size`, baking it if needed. The
+// atlas is `font.baseSize` pixels tall, callers scale by font_size / baseSize as usual.
+// Unknown ids and fonts that fail to load resolve to the built-in font.
+const FontMetrics* font_registry_get(FontRegistry* registry, uint16_t fontId, uint16_t font_size);
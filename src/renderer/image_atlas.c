@@ -0,0 +1,254 @@
+#include "image_atlas.h"
+
+#include "raylib.h"
+#include "rlgl.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+// Power of two, kept at most half full
+constexpr int32_t ENTRY_CAPACITY = 2048;
+
+// Transparent border around every image so neighbours never bleed into each other
+constexpr int GUTTER = 1;
+
+
+static uint32_t hash_texture(unsigned int texture_id) {
+    return texture_id * 0x9E3779B1u;
+}
+
+static AtlasEntry* find_entry(ImageAtlas* atlas, unsigned int texture_id) {
+    uint32_t mask = (uint32_t) (atlas->entry_capacity - 1);
+    for (uint32_t slot = hash_texture(texture_id) & mask;; slot = (slot + 1) & mask) {
+        AtlasEntry* entry = &atlas->entries[slot];
+        if (entry->texture_id == texture_id || entry->texture_id == 0)
+            return entry;
+    }
+}
+
+// Backward shift deletion, keeps every probe chain intact without tombstones
+static void remove_entry(ImageAtlas* atlas, AtlasEntry* entry) {
+    uint32_t mask = (uint32_t) (atlas->entry_capacity - 1);
+    uint32_t hole = (uint32_t) (entry - atlas->entries);
+
+    for (uint32_t slot = (hole + 1) & mask; atlas->entries[slot].texture_id != 0; slot = (slot + 1) & mask) {
+        uint32_t home = hash_texture(atlas->entries[slot].texture_id) & mask;
+
+        // Only move entries whose probe chain passes over the hole
+        bool passes_hole = hole <= slot
+            ? home <= hole || home > slot
+            : home <= hole && home > slot;
+        if (passes_hole) {
+            atlas->entries[hole] = atlas->entries[slot];
+            hole = slot;
+        }
+    }
+
+    atlas->entries[hole] = (AtlasEntry) {};
+    atlas->entry_count -= 1;
+}
+
+static void clear_page(AtlasPage* page) {
+    page->shelf_count = 0;
+    page->free_y = 0;
+
+    BeginTextureMode(page->target);
+    ClearBackground(BLANK);
+    EndTextureMode();
+}
+
+// Best fit shelf packing, the shelf wasting the least height wins
+static bool pack(AtlasPage* page, int width, int height, int* x, int* y) {
+    AtlasShelf* best = nullptr;
+    for (int sdx = 0; sdx < page->shelf_count; ++sdx) {
+        AtlasShelf* shelf = &page->shelves[sdx];
+        if (shelf->height < height || shelf->x + width > IMAGE_ATLAS_PAGE_SIZE)
+            continue;
+        if (best == nullptr || shelf->height < best->height)
+            best = shelf;
+    }
+
+    // Open a new shelf rather than stuffing small images into a much taller one
+    bool wasteful = best != nullptr && best->height > height * 2;
+    if (
+        (best == nullptr || wasteful)
+        && page->shelf_count < IMAGE_ATLAS_MAX_SHELVES
+        && page->free_y + height <= IMAGE_ATLAS_PAGE_SIZE
+    ) {
+        best = &page->shelves[page->shelf_count++];
+        *best = (AtlasShelf) { .y = page->free_y, .height = height };
+        page->free_y += height;
+    }
+
+    if (best == nullptr)
+        return false;
+
+    *x = best->x;
+    *y = best->y;
+    best->x += width;
+    return true;
+}
+
+static void evict_page(ImageAtlas* atlas, int page) {
+    for (int32_t slot = 0; slot < atlas->entry_capacity;) {
+        AtlasEntry* entry = &atlas->entries[slot];
+        // Removing shifts a later entry into this slot, look at it again
+        if (entry->texture_id != 0 && entry->page == page)
+            remove_entry(atlas, entry);
+        else
+            slot += 1;
+    }
+
+    clear_page(&atlas->pages[page]);
+}
+
+// Page with room for the image, creating or evicting pages as needed. -1 if every page
+// is full and was used this frame.
+static int find_page(ImageAtlas* atlas, int width, int height, int* x, int* y) {
+    for (int pdx = 0; pdx < atlas->page_count; ++pdx) {
+        if (pack(&atlas->pages[pdx], width, height, x, y))
+            return pdx;
+    }
+
+    if (atlas->page_count < IMAGE_ATLAS_MAX_PAGES) {
+        AtlasPage* page = &atlas->pages[atlas->page_count];
+        *page = (AtlasPage) { .target = LoadRenderTexture(IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE) };
+        if (page->target.id == 0)
+            return -1;
+
+        clear_page(page);
+        atlas->page_count += 1;
+        return pack(page, width, height, x, y) ? atlas->page_count - 1 : -1;
+    }
+
+    int oldest = -1;
+    for (int pdx = 0; pdx < atlas->page_count; ++pdx) {
+        uint64_t last_used = atlas->pages[pdx].last_used;
+        if (last_used != atlas->frame && (oldest == -1 || last_used < atlas->pages[oldest].last_used))
+            oldest = pdx;
+    }
+    if (oldest == -1)
+        return -1;
+
+    evict_page(atlas, oldest);
+    return pack(&atlas->pages[oldest], width, height, x, y) ? oldest : -1;
+}
+
+// Copies texels as they are, alpha blending over the cleared page would square the alpha
+static void copy_into_page(AtlasPage* page, Texture2D texture, int x, int y) {
+    BeginTextureMode(page->target);
+    rlSetBlendFactorsSeparate(RL_ONE, RL_ZERO, RL_ONE, RL_ZERO, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+
+    DrawTexturePro(
+        texture,
+        (Rectangle) { 0, 0, (float) texture.width, (float) texture.height },
+        (Rectangle) { (float) x, (float) y, (float) texture.width, (float) texture.height },
+        (Vector2) { 0, 0 },
+        0,
+        WHITE
+    );
+
+    EndBlendMode();
+    EndTextureMode();
+}
+
+
+bool image_atlas_init(ImageAtlas* atlas) {
+    *atlas = (ImageAtlas) {};
+
+    atlas->entries = (AtlasEntry*) calloc((size_t) ENTRY_CAPACITY, sizeof(AtlasEntry));
+    if (atlas->entries == nullptr)
+        return false;
+
+    atlas->entry_capacity = ENTRY_CAPACITY;
+    return true;
+}
+
+void image_atlas_free(ImageAtlas* atlas) {
+    for (int pdx = 0; pdx < atlas->page_count; ++pdx)
+        UnloadRenderTexture(atlas->pages[pdx].target);
+
+    free(atlas->entries);
+    *atlas = (ImageAtlas) {};
+}
+
+
+void image_atlas_begin(ImageAtlas* atlas) {
+    atlas->frame += 1;
+}
+
+bool image_atlas_place(ImageAtlas* atlas, Texture2D texture) {
+    if (
+        texture.id == 0
+        || texture.width > IMAGE_ATLAS_MAX_IMAGE_SIZE
+        || texture.height > IMAGE_ATLAS_MAX_IMAGE_SIZE
+    ) {
+        return false;
+    }
+
+    AtlasEntry* entry = find_entry(atlas, texture.id);
+    if (entry->texture_id != 0) {
+        if (entry->width == texture.width && entry->height == texture.height) {
+            atlas->pages[entry->page].last_used = atlas->frame;
+            return true;
+        }
+
+        // Same id, different texture. Its old spot is simply leaked until the page is evicted.
+        remove_entry(atlas, entry);
+    }
+
+    if (atlas->entry_count >= atlas->entry_capacity / 2)
+        return false;
+
+    int x;
+    int y;
+    int page = find_page(atlas, texture.width + GUTTER * 2, texture.height + GUTTER * 2, &x, &y);
+    if (page == -1)
+        return false;
+
+    copy_into_page(&atlas->pages[page], texture, x + GUTTER, y + GUTTER);
+    atlas->pages[page].last_used = atlas->frame;
+
+    // Evicting a page moves entries around, look the slot up again
+    entry = find_entry(atlas, texture.id);
+    *entry = (AtlasEntry) {
+        .texture_id = texture.id,
+        .width = texture.width,
+        .height = texture.height,
+        .page = page,
+        .x = x + GUTTER,
+        .y = y + GUTTER,
+    };
+    atlas->entry_count += 1;
+
+    return true;
+}
+
+AtlasRegion image_atlas_region(ImageAtlas* atlas, Texture2D texture) {
+    AtlasEntry* entry = find_entry(atlas, texture.id);
+    if (entry->texture_id == 0 || entry->width != texture.width || entry->height != texture.height)
+        return (AtlasRegion) { .texture_id = texture.id, .uv = { 0, 0, 1, 1 } };
+
+    // Render textures come out upside down, so rows are addressed from the bottom
+    float size = (float) IMAGE_ATLAS_PAGE_SIZE;
+    return (AtlasRegion) {
+        .texture_id = atlas->pages[entry->page].target.texture.id,
+        .uv = {
+            (float) entry->x / size,
+            (size - (float) entry->y) / size,
+            (float) entry->width / size,
+            -(float) entry->height / size,
+        },
+    };
+}
+
+void image_atlas_forget(ImageAtlas* atlas, unsigned int texture_id) {
+    if (texture_id == 0)
+        return;
+
+    AtlasEntry* entry = find_entry(atlas, texture_id);
+    if (entry->texture_id != 0)
+        remove_entry(atlas, entry);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdint.h>
+
+
+// Images up to this size in both dimensions get packed, larger ones keep their own texture
+constexpr int IMAGE_ATLAS_MAX_IMAGE_SIZE = 128;
+constexpr int IMAGE_ATLAS_PAGE_SIZE = 1024;
+constexpr int IMAGE_ATLAS_MAX_PAGES = 4;
+constexpr int IMAGE_ATLAS_MAX_SHELVES = 128;
+
+// A row of the page images get packed into left to right
+typedef struct AtlasShelf {
+    int y;
+    int height;
+    // Next free column
+    int x;
+} AtlasShelf;
+
+typedef struct AtlasPage {
+    RenderTexture2D target;
+    AtlasShelf shelves[IMAGE_ATLAS_MAX_SHELVES];
+    int shelf_count;
+    // Top of the space no shelf has claimed yet
+    int free_y;
+    // Frame the page was last drawn from, the least recently used page gets evicted whole
+    uint64_t last_used;
+} AtlasPage;
+
+// Where a texture got copied to
+typedef struct AtlasEntry {
+    unsigned int texture_id;
+    int width;
+    int height;
+    int page;
+    int x, y;
+} AtlasEntry;
+
+// Small textures copied into shared render texture pages, so images drawn from the same
+// page batch into one draw call. Textures are copied on the GPU the first time they show up.
+typedef struct ImageAtlas {
+    AtlasPage pages[IMAGE_ATLAS_MAX_PAGES];
+    int page_count;
+
+    // Open addressing on the texture id, texture_id 0 marks an empty slot
+    AtlasEntry* entries;
+    int32_t entry_capacity;
+    int32_t entry_count;
+
+    uint64_t frame;
+} ImageAtlas;
+
+// Texture and normalized source rectangle an image is drawn with
+typedef struct AtlasRegion {
+    unsigned int texture_id;
+    Rectangle uv;
+} AtlasRegion;
+
+
+bool image_atlas_init(ImageAtlas* atlas);
+void image_atlas_free(ImageAtlas* atlas);
+
+// Starts a frame, pages used from here on aren't evicted until the next one
+void image_atlas_begin(ImageAtlas* atlas);
+
+// Makes sure `texture` is in a page, copying it if it isn't. Copying switches render
+// targets, so call this for every image of the frame before drawing anything.
+// Returns false for textures that are too big or don't fit, those are drawn on their own.
+bool image_atlas_place(ImageAtlas* atlas, Texture2D texture);
+
+// Region to draw `texture` from, the texture itself when it isn't in the atlas
+AtlasRegion image_atlas_region(ImageAtlas* atlas, Texture2D texture);
+
+// Drops a texture from the atlas, must be called before unloading a texture that was drawn,
+// otherwise a new texture reusing its id would show the old pixels
+void image_atlas_forget(ImageAtlas* atlas, unsigned int texture_id);
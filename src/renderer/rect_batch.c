@@ -0,0 +1,165 @@
+#include "rect_batch.h"
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+
+// Instances per draw call, the buffer is reused once it fills up
+constexpr int MAX_INSTANCES = 4096;
+
+enum {
+    ATTRIB_CORNER = 0,
+    ATTRIB_RECT,
+    ATTRIB_RADIUS,
+    ATTRIB_BORDER,
+    ATTRIB_COLOR,
+};
+
+static const char* VERTEX_SHADER =
+    "#version 330\n"
+    "layout(location = 0) in vec2 corner;\n"
+    "layout(location = 1) in vec4 rect;\n"
+    "layout(location = 2) in vec4 radius;\n"
+    "layout(location = 3) in vec4 border;\n"
+    "layout(location = 4) in vec4 color;\n"
+    "uniform mat4 mvp;\n"
+    "out vec2 position;\n"
+    "flat out vec4 box;\n"
+    "flat out vec4 boxRadius;\n"
+    "flat out vec4 boxBorder;\n"
+    "flat out vec4 boxColor;\n"
+    "void main() {\n"
+    "    position = rect.xy + corner * rect.zw;\n"
+    "    box = rect;\n"
+    "    boxRadius = min(radius, vec4(min(rect.z, rect.w) * 0.5));\n"
+    "    boxBorder = border;\n"
+    "    boxColor = color;\n"
+    "    gl_Position = mvp * vec4(position, 0.0, 1.0);\n"
+    "}\n";
+
+// Distances are in pixels, so clamping 0.5 - distance gives one pixel of antialiasing
+static const char* FRAGMENT_SHADER =
+    "#version 330\n"
+    "in vec2 position;\n"
+    "flat in vec4 box;\n"
+    "flat in vec4 boxRadius;\n"
+    "flat in vec4 boxBorder;\n"
+    "flat in vec4 boxColor;\n"
+    "out vec4 finalColor;\n"
+    "float roundedBox(vec2 minimum, vec2 maximum, vec4 radius) {\n"
+    "    vec2 center = (minimum + maximum) * 0.5;\n"
+    "    vec2 p = position - center;\n"
+    "    float r = p.x < 0.0 ? (p.y < 0.0 ? radius.x : radius.w) : (p.y < 0.0 ? radius.y : radius.z);\n"
+    "    vec2 q = abs(p) - (maximum - minimum) * 0.5 + r;\n"
+    "    return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;\n"
+    "}\n"
+    "void main() {\n"
+    "    vec2 minimum = box.xy;\n"
+    "    vec2 maximum = box.xy + box.zw;\n"
+    "    float coverage = clamp(0.5 - roundedBox(minimum, maximum, boxRadius), 0.0, 1.0);\n"
+    "    if (any(greaterThan(boxBorder, vec4(0.0)))) {\n"
+    "        vec4 innerRadius = max(boxRadius - max(boxBorder.xyyx, boxBorder.zzww), 0.0);\n"
+    "        vec2 innerMinimum = minimum + boxBorder.xz;\n"
+    "        vec2 innerMaximum = maximum - boxBorder.yw;\n"
+    "        coverage -= clamp(0.5 - roundedBox(innerMinimum, innerMaximum, innerRadius), 0.0, 1.0);\n"
+    "    }\n"
+    "    if (coverage <= 0.0) discard;\n"
+    "    finalColor = vec4(boxColor.rgb, boxColor.a * coverage);\n"
+    "}\n";
+
+
+bool rect_batch_init(RectBatch* batch) {
+    *batch = (RectBatch) {};
+
+    batch->shader_id = rlLoadShaderCode(VERTEX_SHADER, FRAGMENT_SHADER);
+    if (batch->shader_id == 0 || batch->shader_id == rlGetShaderIdDefault()) {
+        batch->shader_id = 0;
+        return false;
+    }
+    batch->mvp_location = rlGetLocationUniform(batch->shader_id, "mvp");
+
+    batch->instances = (RectInstance*) malloc(sizeof(RectInstance) * (size_t) MAX_INSTANCES);
+    if (batch->instances == nullptr) {
+        rect_batch_free(batch);
+        return false;
+    }
+
+    batch->vao_id = rlLoadVertexArray();
+    rlEnableVertexArray(batch->vao_id);
+
+    // Two triangles in the same winding raylib uses for its own quads
+    static const float quad[12] = { 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0 };
+    batch->quad_vbo_id = rlLoadVertexBuffer(quad, sizeof(quad), false);
+    rlSetVertexAttribute(ATTRIB_CORNER, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(ATTRIB_CORNER);
+
+    batch->instance_vbo_id = rlLoadVertexBuffer(nullptr, (int) sizeof(RectInstance) * MAX_INSTANCES, true);
+    rlSetVertexAttribute(ATTRIB_RECT, 4, RL_FLOAT, false, sizeof(RectInstance), offsetof(RectInstance, x));
+    rlSetVertexAttribute(ATTRIB_RADIUS, 4, RL_FLOAT, false, sizeof(RectInstance), offsetof(RectInstance, radius));
+    rlSetVertexAttribute(ATTRIB_BORDER, 4, RL_FLOAT, false, sizeof(RectInstance), offsetof(RectInstance, border));
+    rlSetVertexAttribute(ATTRIB_COLOR, 4, RL_UNSIGNED_BYTE, true, sizeof(RectInstance), offsetof(RectInstance, color));
+    for (unsigned int attrib = ATTRIB_RECT; attrib <= ATTRIB_COLOR; ++attrib) {
+        rlEnableVertexAttribute(attrib);
+        rlSetVertexAttributeDivisor(attrib, 1);
+    }
+
+    rlDisableVertexArray();
+    return true;
+}
+
+void rect_batch_free(RectBatch* batch) {
+    if (batch->vao_id != 0) {
+        rlUnloadVertexBuffer(batch->quad_vbo_id);
+        rlUnloadVertexBuffer(batch->instance_vbo_id);
+        rlUnloadVertexArray(batch->vao_id);
+    }
+    if (batch->shader_id != 0)
+        rlUnloadShaderProgram(batch->shader_id);
+
+    free(batch->instances);
+    *batch = (RectBatch) {};
+}
+
+
+void rect_batch_begin(RectBatch* batch) {
+    batch->instance_count = 0;
+    batch->draw_calls = 0;
+}
+
+void rect_batch_flush(RectBatch* batch) {
+    if (batch->instance_count == 0)
+        return;
+
+    // Anything queued through raylib's own batch came first, it has to land first
+    rlDrawRenderBatchActive();
+
+    rlEnableVertexArray(batch->vao_id);
+    rlUpdateVertexBuffer(
+        batch->instance_vbo_id,
+        batch->instances,
+        (int) sizeof(RectInstance) * batch->instance_count,
+        0
+    );
+
+    rlEnableShader(batch->shader_id);
+    rlSetUniformMatrix(batch->mvp_location, MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+
+    rlDrawVertexArrayInstanced(0, 6, batch->instance_count);
+
+    rlDisableShader();
+    rlDisableVertexArray();
+
+    batch->instance_count = 0;
+    batch->draw_calls += 1;
+}
+
+void rect_batch_push(RectBatch* batch, RectInstance instance) {
+    if (batch->instance_count == MAX_INSTANCES)
+        rect_batch_flush(batch);
+
+    batch->instances[batch->instance_count++] = instance;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "raylib.h"
+
+
+// One rounded box, filled or outlined, shaded entirely in the fragment shader
+typedef struct RectInstance {
+    float x, y, width, height;
+    // Top left, top right, bottom right, bottom left
+    float radius[4];
+    // Left, right, top, bottom. All zero draws a filled box.
+    float border[4];
+    Color color;
+} RectInstance;
+
+// Rectangles and borders drawn as instanced quads. The fragment shader evaluates a
+// rounded box distance per pixel, so corners are antialiased and nothing is tessellated.
+typedef struct RectBatch {
+    RectInstance* instances;
+    int instance_count;
+
+    unsigned int vao_id;
+    unsigned int quad_vbo_id;
+    unsigned int instance_vbo_id;
+
+    unsigned int shader_id;
+    int mvp_location;
+
+    // Draw calls issued since the last rect_batch_begin()
+    int draw_calls;
+} RectBatch;
+
+
+// Fails when allocating or compiling the shader fails, callers tessellate instead
+bool rect_batch_init(RectBatch* batch);
+void rect_batch_free(RectBatch* batch);
+
+void rect_batch_begin(RectBatch* batch);
+void rect_batch_flush(RectBatch* batch);
+
+void rect_batch_push(RectBatch* batch, RectInstance instance);
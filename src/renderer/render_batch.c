@@ -0,0 +1,218 @@
+#include "render_batch.h"
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+
+// rlgl draws elements with 16-bit indices, so one flush can address at most this many vertices
+constexpr int MAX_VERTICES = 1 << 16;
+constexpr int MAX_INDICES = MAX_VERTICES * 3;
+
+
+bool render_batch_init(RenderBatch* batch) {
+    *batch = (RenderBatch) {};
+
+    batch->vertices = (RenderVertex*) malloc(sizeof(RenderVertex) * (size_t) MAX_VERTICES);
+    batch->indices = (uint16_t*) malloc(sizeof(uint16_t) * (size_t) MAX_INDICES);
+    if (batch->vertices == nullptr || batch->indices == nullptr) {
+        render_batch_free(batch);
+        return false;
+    }
+
+    // The element buffer binding is VAO state, so everything is set up with the VAO bound
+    batch->vao_id = rlLoadVertexArray();
+    rlEnableVertexArray(batch->vao_id);
+
+    batch->vbo_id = rlLoadVertexBuffer(nullptr, (int) sizeof(RenderVertex) * MAX_VERTICES, true);
+    rlSetVertexAttribute(
+        RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION,
+        2,
+        RL_FLOAT,
+        false,
+        sizeof(RenderVertex),
+        offsetof(RenderVertex, x)
+    );
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+    rlSetVertexAttribute(
+        RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD,
+        2,
+        RL_FLOAT,
+        false,
+        sizeof(RenderVertex),
+        offsetof(RenderVertex, u)
+    );
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+    rlSetVertexAttribute(
+        RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR,
+        4,
+        RL_UNSIGNED_BYTE,
+        true,
+        sizeof(RenderVertex),
+        offsetof(RenderVertex, color)
+    );
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+
+    batch->ebo_id = rlLoadVertexBufferElement(nullptr, (int) sizeof(uint16_t) * MAX_INDICES, true);
+
+    rlDisableVertexArray();
+    return true;
+}
+
+void render_batch_free(RenderBatch* batch) {
+    if (batch->vao_id != 0) {
+        rlUnloadVertexBuffer(batch->vbo_id);
+        rlUnloadVertexBuffer(batch->ebo_id);
+        rlUnloadVertexArray(batch->vao_id);
+    }
+
+    free(batch->vertices);
+    free(batch->indices);
+    *batch = (RenderBatch) {};
+}
+
+
+void render_batch_begin(RenderBatch* batch) {
+    batch->vertex_count = 0;
+    batch->index_count = 0;
+    batch->draw_calls = 0;
+
+    // raylib points its shapes texture at a white patch of the default font atlas,
+    // so solid geometry shares a texture with default-font text and batches with it
+    Texture2D shapes = GetShapesTexture();
+    Rectangle patch = GetShapesTextureRectangle();
+    batch->solid_texture_id = shapes.id;
+    batch->solid_u = (patch.x + patch.width / 2) / (float) shapes.width;
+    batch->solid_v = (patch.y + patch.height / 2) / (float) shapes.height;
+    batch->texture_id = batch->solid_texture_id;
+
+    batch->shader = render_batch_default_shader();
+    batch->queued_shader = batch->shader;
+}
+
+void render_batch_flush(RenderBatch* batch) {
+    if (batch->index_count == 0)
+        return;
+
+    // Anything queued through raylib's own batch came first, it has to land first
+    rlDrawRenderBatchActive();
+
+    rlEnableVertexArray(batch->vao_id);
+    rlUpdateVertexBuffer(
+        batch->vbo_id,
+        batch->vertices,
+        (int) sizeof(RenderVertex) * batch->vertex_count,
+        0
+    );
+    rlUpdateVertexBufferElements(
+        batch->ebo_id,
+        batch->indices,
+        (int) sizeof(uint16_t) * batch->index_count,
+        0
+    );
+
+    int* locs = batch->queued_shader.locs;
+    rlEnableShader(batch->queued_shader.id);
+    rlSetUniformMatrix(
+        locs[RL_SHADER_LOC_MATRIX_MVP],
+        MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection())
+    );
+    rlSetUniform(
+        locs[RL_SHADER_LOC_COLOR_DIFFUSE],
+        (float[4]) { 1, 1, 1, 1 },
+        RL_SHADER_UNIFORM_VEC4,
+        1
+    );
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(batch->texture_id);
+
+    rlDrawVertexArrayElements(0, batch->index_count, nullptr);
+
+    rlDisableTexture();
+    rlDisableShader();
+    rlDisableVertexArray();
+
+    batch->vertex_count = 0;
+    batch->index_count = 0;
+    batch->draw_calls += 1;
+}
+
+void render_batch_set_shader(RenderBatch* batch, Shader shader) {
+    batch->shader = shader;
+}
+
+Shader render_batch_default_shader(void) {
+    return (Shader) { .id = rlGetShaderIdDefault(), .locs = rlGetShaderLocsDefault() };
+}
+
+
+RenderBatchSpan render_batch_reserve(
+    RenderBatch* batch,
+    unsigned int texture_id,
+    int vertex_count,
+    int index_count
+) {
+    if (
+        texture_id != batch->texture_id
+        || batch->shader.id != batch->queued_shader.id
+        || batch->vertex_count + vertex_count > MAX_VERTICES
+        || batch->index_count + index_count > MAX_INDICES
+    ) {
+        render_batch_flush(batch);
+        batch->texture_id = texture_id;
+        batch->queued_shader = batch->shader;
+    }
+
+    RenderBatchSpan span = {
+        .vertices = batch->vertices + batch->vertex_count,
+        .indices = batch->indices + batch->index_count,
+        .base = (uint16_t) batch->vertex_count,
+    };
+
+    batch->vertex_count += vertex_count;
+    batch->index_count += index_count;
+
+    return span;
+}
+
+void render_batch_push_quad(
+    RenderBatch* batch,
+    unsigned int texture_id,
+    Rectangle dst,
+    Rectangle uv,
+    Color color
+) {
+    RenderBatchSpan span = render_batch_reserve(batch, texture_id, 4, 6);
+
+    float x1 = dst.x + dst.width;
+    float y1 = dst.y + dst.height;
+    float u1 = uv.x + uv.width;
+    float v1 = uv.y + uv.height;
+
+    span.vertices[0] = (RenderVertex) { dst.x, dst.y, uv.x, uv.y, color };
+    span.vertices[1] = (RenderVertex) { dst.x, y1, uv.x, v1, color };
+    span.vertices[2] = (RenderVertex) { x1, y1, u1, v1, color };
+    span.vertices[3] = (RenderVertex) { x1, dst.y, u1, uv.y, color };
+
+    const uint16_t base = span.base;
+    span.indices[0] = base;
+    span.indices[1] = (uint16_t) (base + 1);
+    span.indices[2] = (uint16_t) (base + 2);
+    span.indices[3] = base;
+    span.indices[4] = (uint16_t) (base + 2);
+    span.indices[5] = (uint16_t) (base + 3);
+}
+
+void render_batch_push_rect(RenderBatch* batch, Rectangle dst, Color color) {
+    render_batch_push_quad(
+        batch,
+        batch->solid_texture_id,
+        dst,
+        (Rectangle) { batch->solid_u, batch->solid_v, 0, 0 },
+        color
+    );
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdint.h>
+
+
+typedef struct RenderVertex {
+    float x, y;
+    float u, v;
+    Color color;
+} RenderVertex;
+
+typedef struct RenderBatch {
+    RenderVertex* vertices;
+    uint16_t* indices;
+    int vertex_count;
+    int index_count;
+
+    // Texture and shader used by every vertex currently queued
+    unsigned int texture_id;
+    Shader queued_shader;
+    // Shader geometry reserved from now on is drawn with, see render_batch_set_shader()
+    Shader shader;
+
+    // Texel that samples as opaque white, used for untextured geometry
+    unsigned int solid_texture_id;
+    float solid_u, solid_v;
+
+    unsigned int vao_id;
+    unsigned int vbo_id;
+    unsigned int ebo_id;
+
+    // Draw calls issued since the last render_batch_begin()
+    int draw_calls;
+} RenderBatch;
+
+// Writable region handed out by render_batch_reserve()
+typedef struct RenderBatchSpan {
+    RenderVertex* vertices;
+    uint16_t* indices;
+    // Indices must be offset by this to address the reserved vertices
+    uint16_t base;
+} RenderBatchSpan;
+
+
+bool render_batch_init(RenderBatch* batch);
+void render_batch_free(RenderBatch* batch);
+
+void render_batch_begin(RenderBatch* batch);
+void render_batch_flush(RenderBatch* batch);
+
+// Switches the shader for geometry reserved afterwards. Nothing is flushed until geometry
+// with the new shader actually gets reserved, so switching back and forth is free.
+void render_batch_set_shader(RenderBatch* batch, Shader shader);
+Shader render_batch_default_shader(void);
+
+RenderBatchSpan render_batch_reserve(
+    RenderBatch* batch,
+    unsigned int texture_id,
+    int vertex_count,
+    int index_count
+);
+
+void render_batch_push_quad(
+    RenderBatch* batch,
+    unsigned int texture_id,
+    Rectangle dst,
+    Rectangle uv,
+    Color color
+);
+void render_batch_push_rect(RenderBatch* batch, Rectangle dst, Color color);
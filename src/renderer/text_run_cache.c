@@ -0,0 +1,267 @@
+#include "text_run_cache.h"
+
+#include "clay.h"
+#include "fingerprint.h"
+#include "font_metrics.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+constexpr int32_t SLOT_CAPACITY = TEXT_RUN_CACHE_MAX_RUNS * 2;
+
+// A single run may take this share of the budget at most, so one huge paste can't
+// flush everything else
+constexpr size_t MAX_RUN_BYTES = TEXT_RUN_CACHE_BUDGET / 16;
+
+
+static uint32_t home_slot(uint64_t hash) {
+    return (uint32_t) (hash >> 32) & (SLOT_CAPACITY - 1);
+}
+
+static uint64_t run_hash(Clay_TextRenderData* text) {
+    uint64_t hash = fingerprint_bytes(text->stringContents.chars, text->stringContents.length);
+    uint64_t config = (uint64_t) text->fontId | (uint64_t) text->fontSize << 16 | (uint64_t) text->letterSpacing << 32;
+    return (hash ^ config) * 0x9E3779B97F4A7C15u;
+}
+
+static bool matches(const TextRun* run, uint64_t hash, Clay_TextRenderData* text, unsigned int texture_id) {
+    return run->hash == hash
+        && run->length == text->stringContents.length
+        && run->font_id == text->fontId
+        && run->font_size == text->fontSize
+        && run->letter_spacing == text->letterSpacing
+        && run->texture_id == texture_id;
+}
+
+// Glyph quads of `text` relative to its start, `quads` needs room for one per byte
+static int32_t layout(const FontMetrics* metrics, Clay_TextRenderData* text, TextRunQuad* quads) {
+    const Font* font = &metrics->font;
+
+    float fontSize = (float) text->fontSize;
+    float spacing = (float) text->letterSpacing;
+    float scaleFactor = fontSize / (float) font->baseSize;
+    float padding = (float) font->glyphPadding;
+    float texelWidth = 1.0f / (float) font->texture.width;
+    float texelHeight = 1.0f / (float) font->texture.height;
+
+    const char* chars = text->stringContents.chars;
+    int32_t length = text->stringContents.length;
+    int32_t count = 0;
+
+    Vector2 pen = { 0, 0 };
+    for (int32_t idx = 0; idx < length;) {
+        int32_t size;
+        int32_t codepoint = utf8_decode(chars + idx, length - idx, &size);
+        idx += size;
+
+        if (codepoint == '\n') {
+            pen.x = 0;
+            pen.y += fontSize;
+            continue;
+        }
+
+        int glyph = font_metrics_glyph_index(metrics, codepoint);
+        if (codepoint != ' ' && codepoint != '\t') {
+            Rectangle rec = font->recs[glyph];
+            quads[count++] = (TextRunQuad) {
+                .dst = {
+                    pen.x + ((float) font->glyphs[glyph].offsetX - padding) * scaleFactor,
+                    pen.y + ((float) font->glyphs[glyph].offsetY - padding) * scaleFactor,
+                    (rec.width + 2 * padding) * scaleFactor,
+                    (rec.height + 2 * padding) * scaleFactor,
+                },
+                .uv = {
+                    (rec.x - padding) * texelWidth,
+                    (rec.y - padding) * texelHeight,
+                    (rec.width + 2 * padding) * texelWidth,
+                    (rec.height + 2 * padding) * texelHeight,
+                },
+            };
+        }
+
+        pen.x += metrics->glyph_advance[glyph] * scaleFactor + spacing;
+    }
+
+    return count;
+}
+
+static void unlink(TextRunCache* cache, int32_t index) {
+    TextRun* run = &cache->runs[index];
+    if (run->newer >= 0)
+        cache->runs[run->newer].older = run->older;
+    else
+        cache->newest = run->older;
+
+    if (run->older >= 0)
+        cache->runs[run->older].newer = run->newer;
+    else
+        cache->oldest = run->newer;
+}
+
+static void link_newest(TextRunCache* cache, int32_t index) {
+    TextRun* run = &cache->runs[index];
+    run->newer = -1;
+    run->older = cache->newest;
+    if (cache->newest >= 0)
+        cache->runs[cache->newest].newer = index;
+    else
+        cache->oldest = index;
+
+    cache->newest = index;
+}
+
+static uint32_t find_slot(const TextRunCache* cache, uint64_t hash, Clay_TextRenderData* text, unsigned int texture_id) {
+    uint32_t mask = SLOT_CAPACITY - 1;
+    uint32_t slot = home_slot(hash);
+    while (cache->slots[slot] != 0 && !matches(&cache->runs[cache->slots[slot] - 1], hash, text, texture_id))
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+// Backward shift deletion, keeps every probe chain intact without tombstones
+static void remove_slot(TextRunCache* cache, uint32_t hole) {
+    uint32_t mask = SLOT_CAPACITY - 1;
+
+    for (uint32_t slot = (hole + 1) & mask; cache->slots[slot] != 0; slot = (slot + 1) & mask) {
+        uint32_t home = home_slot(cache->runs[cache->slots[slot] - 1].hash);
+
+        // Only move entries whose probe chain passes over the hole
+        bool passes_hole = hole <= slot
+            ? home <= hole || home > slot
+            : home <= hole && home > slot;
+        if (passes_hole) {
+            cache->slots[hole] = cache->slots[slot];
+            hole = slot;
+        }
+    }
+
+    cache->slots[hole] = 0;
+}
+
+static void evict_oldest(TextRunCache* cache) {
+    int32_t index = cache->oldest;
+    TextRun* run = &cache->runs[index];
+
+    uint32_t mask = SLOT_CAPACITY - 1;
+    uint32_t slot = home_slot(run->hash);
+    while (cache->slots[slot] != index + 1)
+        slot = (slot + 1) & mask;
+    remove_slot(cache, slot);
+
+    unlink(cache, index);
+    cache->bytes -= sizeof(TextRunQuad) * (size_t) run->quad_count;
+    free(run->quads);
+    *run = (TextRun) { .older = cache->free_run };
+    cache->free_run = index;
+    cache->run_count -= 1;
+}
+
+// Lays the text out into the scratch run, which is never kept
+static const TextRun* layout_scratch(TextRunCache* cache, const FontMetrics* metrics, Clay_TextRenderData* text) {
+    int32_t length = text->stringContents.length;
+    if (length > cache->scratch_capacity) {
+        TextRunQuad* quads = (TextRunQuad*) realloc(cache->scratch.quads, sizeof(TextRunQuad) * (size_t) length);
+        if (quads == nullptr)
+            return nullptr;
+
+        cache->scratch.quads = quads;
+        cache->scratch_capacity = length;
+    }
+
+    cache->scratch.texture_id = metrics->font.texture.id;
+    cache->scratch.quad_count = layout(metrics, text, cache->scratch.quads);
+    return &cache->scratch;
+}
+
+
+bool text_run_cache_init(TextRunCache* cache) {
+    *cache = (TextRunCache) { .free_run = -1, .newest = -1, .oldest = -1 };
+
+    cache->runs = (TextRun*) calloc(TEXT_RUN_CACHE_MAX_RUNS, sizeof(TextRun));
+    cache->slots = (int32_t*) calloc(SLOT_CAPACITY, sizeof(int32_t));
+    if (cache->runs == nullptr || cache->slots == nullptr) {
+        text_run_cache_free(cache);
+        return false;
+    }
+
+    for (int32_t index = TEXT_RUN_CACHE_MAX_RUNS - 1; index >= 0; --index) {
+        cache->runs[index].older = cache->free_run;
+        cache->free_run = index;
+    }
+
+    return true;
+}
+
+void text_run_cache_free(TextRunCache* cache) {
+    if (cache->runs != nullptr) {
+        for (int32_t index = cache->newest; index >= 0; index = cache->runs[index].older)
+            free(cache->runs[index].quads);
+    }
+
+    free(cache->runs);
+    free(cache->slots);
+    free(cache->scratch.quads);
+    *cache = (TextRunCache) {};
+}
+
+const TextRun* text_run_cache_get(TextRunCache* cache, const FontMetrics* metrics, Clay_TextRenderData* text) {
+    uint64_t hash = run_hash(text);
+    unsigned int texture_id = metrics->font.texture.id;
+    uint32_t slot = find_slot(cache, hash, text, texture_id);
+
+    if (cache->slots[slot] != 0) {
+        int32_t index = cache->slots[slot] - 1;
+        unlink(cache, index);
+        link_newest(cache, index);
+        cache->hits += 1;
+        return &cache->runs[index];
+    }
+    cache->misses += 1;
+
+    // Every glyph is one byte at least, so the length bounds the quad count
+    int32_t length = text->stringContents.length;
+    size_t most_bytes = sizeof(TextRunQuad) * (size_t) length;
+    if (most_bytes > MAX_RUN_BYTES)
+        return layout_scratch(cache, metrics, text);
+
+    TextRunQuad* quads = (TextRunQuad*) malloc(most_bytes > 0 ? most_bytes : 1);
+    if (quads == nullptr)
+        return layout_scratch(cache, metrics, text);
+
+    int32_t quad_count = layout(metrics, text, quads);
+    size_t bytes = sizeof(TextRunQuad) * (size_t) quad_count;
+    // Multi byte characters and spaces leave the end unused
+    if (quad_count < length) {
+        TextRunQuad* trimmed = (TextRunQuad*) realloc(quads, bytes > 0 ? bytes : 1);
+        quads = trimmed != nullptr ? trimmed : quads;
+    }
+
+    while (cache->oldest >= 0 && (cache->bytes + bytes > TEXT_RUN_CACHE_BUDGET || cache->free_run < 0))
+        evict_oldest(cache);
+
+    // Eviction moved slots around
+    slot = find_slot(cache, hash, text, texture_id);
+
+    int32_t index = cache->free_run;
+    TextRun* run = &cache->runs[index];
+    cache->free_run = run->older;
+    *run = (TextRun) {
+        .hash = hash,
+        .length = length,
+        .font_id = text->fontId,
+        .font_size = text->fontSize,
+        .letter_spacing = text->letterSpacing,
+        .texture_id = texture_id,
+        .quads = quads,
+        .quad_count = quad_count,
+    };
+    link_newest(cache, index);
+    cache->slots[slot] = index + 1;
+    cache->bytes += bytes;
+    cache->run_count += 1;
+
+    return run;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "clay.h"
+#include "font_metrics.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Memory the cached glyph quads may take before the least recently drawn runs are evicted
+constexpr size_t TEXT_RUN_CACHE_BUDGET = 4 << 20;
+// Most runs kept at once, the lookup table has twice as many slots
+constexpr int32_t TEXT_RUN_CACHE_MAX_RUNS = 8192;
+
+// One glyph, positioned relative to where the run starts
+typedef struct TextRunQuad {
+    Rectangle dst;
+    Rectangle uv;
+} TextRunQuad;
+
+// A laid out line of text, keyed by its contents, fontId, fontSize and letterSpacing.
+// Color isn't part of the key, it's applied while drawing.
+typedef struct TextRun {
+    uint64_t hash;
+    int32_t length;
+    uint16_t font_id;
+    uint16_t font_size;
+    uint16_t letter_spacing;
+    // Atlas the quads sample, runs laid out against another atlas don't match
+    unsigned int texture_id;
+
+    TextRunQuad* quads;
+    int32_t quad_count;
+
+    // Most recently drawn first, indices into the runs, -1 at either end
+    int32_t newer;
+    int32_t older;
+} TextRun;
+
+// Chat messages don't change once sent, so the glyph layout of each wrapped line is kept
+// across frames and drawing it again is a copy. Runs that don't fit are laid out into a
+// scratch run every time they're drawn instead.
+typedef struct TextRunCache {
+    TextRun* runs;
+    int32_t run_count;
+    // Unused runs chain through `older`
+    int32_t free_run;
+
+    // Open addressing on the hash, run index + 1, 0 marks an empty slot
+    int32_t* slots;
+
+    int32_t newest;
+    int32_t oldest;
+
+    size_t bytes;
+    TextRun scratch;
+    int32_t scratch_capacity;
+
+    uint64_t hits;
+    uint64_t misses;
+} TextRunCache;
+
+
+bool text_run_cache_init(TextRunCache* cache);
+void text_run_cache_free(TextRunCache* cache);
+
+// The laid out run for `text`, from the cache or laid out now. Valid until the next call,
+// nullptr when out of memory.
+const TextRun* text_run_cache_get(TextRunCache* cache, const FontMetrics* metrics, Clay_TextRenderData* text);
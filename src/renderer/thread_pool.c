@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "thread_pool.h"
+
+#include "../trace.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+static bool claim(ThreadPoolQueue* queue, int32_t* index) {
+    // Relaxed is enough, the job itself is published through the pool's mutex
+    int32_t next = atomic_fetch_add_explicit(&queue->next, 1, memory_order_relaxed);
+    if (next >= queue->end)
+        return false;
+
+    *index = next;
+    return true;
+}
+
+static void work(ThreadPool* pool, int worker) {
+    TRACE_BEGIN("pool job");
+
+    int32_t index;
+    while (claim(&pool->queues[worker], &index))
+        pool->task(pool->context, index);
+
+    // Own share done, help whoever is still busy starting with the next thread over
+    for (int offset = 1; offset < pool->thread_count; ++offset) {
+        ThreadPoolQueue* victim = &pool->queues[(worker + offset) % pool->thread_count];
+        while (claim(victim, &index))
+            pool->task(pool->context, index);
+    }
+
+    TRACE_END();
+}
+
+static void* worker_main(void* arg) {
+    ThreadPoolWorker* worker = (ThreadPoolWorker*) arg;
+    ThreadPool* pool = worker->pool;
+    uint64_t seen = 0;
+
+    TRACE_THREAD_NAME("pool worker");
+
+    while (true) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->stopping)
+            pthread_cond_wait(&pool->start, &pool->lock);
+
+        if (pool->stopping) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        work(pool, worker->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return nullptr;
+}
+
+
+bool thread_pool_init(ThreadPool* pool, int thread_count) {
+    *pool = (ThreadPool) {};
+
+    if (thread_count <= 0)
+        thread_count = thread_pool_processor_count();
+
+    pool->workers = (ThreadPoolWorker*) calloc((size_t) thread_count, sizeof(ThreadPoolWorker));
+    pool->queues = (ThreadPoolQueue*) aligned_alloc(
+        alignof(ThreadPoolQueue),
+        sizeof(ThreadPoolQueue) * (size_t) thread_count
+    );
+    if (pool->workers == nullptr || pool->queues == nullptr) {
+        free(pool->workers);
+        free(pool->queues);
+        return false;
+    }
+
+    pthread_mutex_init(&pool->lock, nullptr);
+    pthread_cond_init(&pool->start, nullptr);
+    pthread_cond_init(&pool->done, nullptr);
+
+    // Thread 0 is whoever runs the job
+    pool->thread_count = 1;
+    for (int tdx = 1; tdx < thread_count; ++tdx) {
+        ThreadPoolWorker* worker = &pool->workers[tdx];
+        *worker = (ThreadPoolWorker) { .pool = pool, .index = tdx };
+        if (pthread_create(&worker->thread, nullptr, worker_main, worker) != 0)
+            break;
+
+        pool->thread_count += 1;
+    }
+
+    return true;
+}
+
+void thread_pool_free(ThreadPool* pool) {
+    if (pool->workers == nullptr)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int tdx = 1; tdx < pool->thread_count; ++tdx)
+        pthread_join(pool->workers[tdx].thread, nullptr);
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+
+    free(pool->workers);
+    free(pool->queues);
+    *pool = (ThreadPool) {};
+}
+
+int thread_pool_processor_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+}
+
+
+void thread_pool_run(ThreadPool* pool, int32_t count, ThreadPoolTask task, void* context) {
+    if (pool->thread_count <= 1 || count <= 1) {
+        for (int32_t index = 0; index < count; ++index)
+            task(context, index);
+        return;
+    }
+
+    for (int tdx = 0; tdx < pool->thread_count; ++tdx) {
+        ThreadPoolQueue* queue = &pool->queues[tdx];
+        atomic_store_explicit(&queue->next, (int32_t) ((int64_t) count * tdx / pool->thread_count), memory_order_relaxed);
+        queue->end = (int32_t) ((int64_t) count * (tdx + 1) / pool->thread_count);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->busy = pool->thread_count - 1;
+    pool->generation += 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+
+// Runs `task` once for every index of a job
+typedef void (*ThreadPoolTask)(void* context, int32_t index);
+
+// Indices of a job one thread starts out with. Claimed from the front by the owner and
+// thieves alike, so a steal is the same single atomic add as taking one's own work.
+typedef struct ThreadPoolQueue {
+    alignas(64) _Atomic int32_t next;
+    int32_t end;
+} ThreadPoolQueue;
+
+typedef struct ThreadPoolWorker {
+    struct ThreadPool* pool;
+    pthread_t thread;
+    int index;
+} ThreadPoolWorker;
+
+// Fixed set of threads working through index ranges. A job's indices are split evenly
+// between the threads up front, and threads that finish their share steal from the
+// others, so jobs with uneven tasks still keep every thread busy.
+typedef struct ThreadPool {
+    // The thread calling thread_pool_run() works as thread 0, the rest are spawned
+    int thread_count;
+    ThreadPoolWorker* workers;
+    ThreadPoolQueue* queues;
+
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    // Bumped for every job, spawned threads sleep until it changes
+    uint64_t generation;
+    // Spawned threads still working on the current job
+    int busy;
+    bool stopping;
+
+    ThreadPoolTask task;
+    void* context;
+} ThreadPool;
+
+
+// `thread_count` includes the calling thread, 0 means one per online processor.
+// Falls back to fewer threads if some can't be spawned.
+bool thread_pool_init(ThreadPool* pool, int thread_count);
+void thread_pool_free(ThreadPool* pool);
+
+int thread_pool_processor_count(void);
+
+// Runs task(context, index) for every index in [0, count) and returns once all are done.
+// Tasks run concurrently in no particular order.
+void thread_pool_run(ThreadPool* pool, int32_t count, ThreadPoolTask task, void* context);
@@ -0,0 +1,201 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+// Single producer, single consumer: the owning thread pushes finished spans at `head`, the
+// flushing thread takes them from `tail`. Neither ever waits for the other.
+typedef struct TraceBuffer {
+    TraceEvent events[TRACE_BUFFER_CAPACITY];
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    _Atomic uint64_t dropped;
+    _Atomic(const char*) name;
+
+    // Owning thread only, spans that began but haven't ended
+    TraceEvent open[TRACE_MAX_DEPTH];
+    int depth;
+
+    // Flushing thread only
+    bool name_written;
+
+    uint32_t thread_id;
+    struct TraceBuffer* next;
+} TraceBuffer;
+
+// Every thread that recorded anything, newest first. Only ever grows while tracing.
+static _Atomic(TraceBuffer*) buffers;
+static atomic_uint next_thread_id;
+static atomic_bool running;
+static thread_local TraceBuffer* local_buffer;
+
+// Flushes come from any thread, the file is written by one at a time
+static pthread_mutex_t flush_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE* file;
+static const char* separator;
+// Timestamps are written relative to trace_init()
+static uint64_t origin;
+
+
+static uint64_t now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+static double microseconds(uint64_t nanoseconds) {
+    return (double) nanoseconds / 1000.0;
+}
+
+static TraceBuffer* register_thread(void) {
+    TraceBuffer* buffer = (TraceBuffer*) calloc(1, sizeof(TraceBuffer));
+    if (buffer == nullptr)
+        return nullptr;
+
+    buffer->thread_id = atomic_fetch_add(&next_thread_id, 1) + 1;
+
+    TraceBuffer* head = atomic_load_explicit(&buffers, memory_order_relaxed);
+    do {
+        buffer->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(
+        &buffers, &head, buffer, memory_order_release, memory_order_relaxed
+    ));
+
+    local_buffer = buffer;
+    return buffer;
+}
+
+static void push(TraceBuffer* buffer, TraceEvent event) {
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&buffer->tail, memory_order_acquire);
+    if (head - tail == TRACE_BUFFER_CAPACITY) {
+        atomic_fetch_add_explicit(&buffer->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[head & (TRACE_BUFFER_CAPACITY - 1)] = event;
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+static void flush_buffer(TraceBuffer* buffer) {
+    const char* name = atomic_load_explicit(&buffer->name, memory_order_acquire);
+    if (name != nullptr && !buffer->name_written) {
+        fprintf(
+            file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            separator, buffer->thread_id, name
+        );
+        separator = ",\n";
+        buffer->name_written = true;
+    }
+
+    uint64_t tail = atomic_load_explicit(&buffer->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+    for (uint64_t idx = tail; idx < head; ++idx) {
+        const TraceEvent* event = &buffer->events[idx & (TRACE_BUFFER_CAPACITY - 1)];
+        fprintf(
+            file,
+            "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            separator, event->name, buffer->thread_id,
+            microseconds(event->start - origin), microseconds(event->duration)
+        );
+        separator = ",\n";
+    }
+    atomic_store_explicit(&buffer->tail, head, memory_order_release);
+
+    uint64_t dropped = atomic_exchange_explicit(&buffer->dropped, 0, memory_order_relaxed);
+    if (dropped > 0)
+        fprintf(stderr, "Warning: Trace thread %u dropped %llu spans\n", buffer->thread_id, (unsigned long long) dropped);
+}
+
+
+bool trace_init(const char* path) {
+    pthread_mutex_lock(&flush_lock);
+    file = fopen(path, "w");
+    if (file != nullptr) {
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+        separator = "";
+        origin = now();
+        atomic_store(&running, true);
+    }
+    pthread_mutex_unlock(&flush_lock);
+
+    return file != nullptr;
+}
+
+void trace_flush(void) {
+    pthread_mutex_lock(&flush_lock);
+    if (file != nullptr) {
+        TraceBuffer* buffer = atomic_load_explicit(&buffers, memory_order_acquire);
+        for (; buffer != nullptr; buffer = buffer->next)
+            flush_buffer(buffer);
+        fflush(file);
+    }
+    pthread_mutex_unlock(&flush_lock);
+}
+
+void trace_shutdown(void) {
+    atomic_store(&running, false);
+    trace_flush();
+
+    pthread_mutex_lock(&flush_lock);
+    if (file != nullptr) {
+        fputs("\n]}\n", file);
+        fclose(file);
+        file = nullptr;
+    }
+
+    // Every other thread is expected to be done recording by now
+    TraceBuffer* buffer = atomic_exchange(&buffers, nullptr);
+    while (buffer != nullptr) {
+        TraceBuffer* next = buffer->next;
+        free(buffer);
+        buffer = next;
+    }
+    local_buffer = nullptr;
+    pthread_mutex_unlock(&flush_lock);
+}
+
+
+void trace_thread_name(const char* name) {
+    if (!atomic_load_explicit(&running, memory_order_relaxed))
+        return;
+
+    TraceBuffer* buffer = local_buffer != nullptr ? local_buffer : register_thread();
+    if (buffer != nullptr)
+        atomic_store_explicit(&buffer->name, name, memory_order_release);
+}
+
+void trace_begin(const char* name) {
+    if (!atomic_load_explicit(&running, memory_order_relaxed))
+        return;
+
+    TraceBuffer* buffer = local_buffer != nullptr ? local_buffer : register_thread();
+    if (buffer == nullptr)
+        return;
+
+    if (buffer->depth < TRACE_MAX_DEPTH)
+        buffer->open[buffer->depth] = (TraceEvent) { .name = name, .start = now() };
+    buffer->depth += 1;
+}
+
+void trace_end(void) {
+    TraceBuffer* buffer = local_buffer;
+    if (!atomic_load_explicit(&running, memory_order_relaxed) || buffer == nullptr || buffer->depth == 0)
+        return;
+
+    buffer->depth -= 1;
+    if (buffer->depth >= TRACE_MAX_DEPTH)
+        return;
+
+    TraceEvent event = buffer->open[buffer->depth];
+    event.duration = now() - event.start;
+    push(buffer, event);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// Span tracing to Chrome Trace Event JSON, to open in Perfetto or chrome://tracing.
+// Only built with `make TRACE=1`, otherwise every macro here compiles to nothing.
+//
+// Every thread records into its own ring buffer without taking locks, spans are written
+// out when TRACE_FLUSH() is called and at TRACE_SHUTDOWN(). Spans that don't fit in a
+// full buffer are dropped and counted, flush often enough to keep up.
+
+#if defined(CCHAT_TRACE)
+
+#include <stdint.h>
+
+
+// Per thread
+constexpr int TRACE_BUFFER_CAPACITY = 1 << 16;
+// Deepest nesting of spans on one thread, deeper spans aren't recorded
+constexpr int TRACE_MAX_DEPTH = 32;
+
+// A finished span, names are string literals so only the pointer is kept
+typedef struct TraceEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+} TraceEvent;
+
+
+bool trace_init(const char* path);
+// Writes everything recorded so far
+void trace_flush(void);
+// Flushes and closes the file, nothing is recorded afterwards. Other threads must be
+// done recording, their buffers are freed. Tracing can't be started again.
+void trace_shutdown(void);
+
+// Shows up as the thread's name in the trace, `name` has to outlive the trace
+void trace_thread_name(const char* name);
+
+void trace_begin(const char* name);
+void trace_end(void);
+
+#define TRACE_INIT(path) trace_init(path)
+#define TRACE_FLUSH() trace_flush()
+#define TRACE_SHUTDOWN() trace_shutdown()
+#define TRACE_THREAD_NAME(name) trace_thread_name(name)
+#define TRACE_BEGIN(name) trace_begin(name)
+#define TRACE_END() trace_end()
+
+// Clay's own phases, see the hooks at the top of its implementation
+#define CLAY__TRACE_BEGIN(name) trace_begin(name)
+#define CLAY__TRACE_END() trace_end()
+
+#else
+
+#define TRACE_INIT(path) ((void) (path), true)
+#define TRACE_FLUSH() ((void) 0)
+#define TRACE_SHUTDOWN() ((void) 0)
+#define TRACE_THREAD_NAME(name) ((void) 0)
+#define TRACE_BEGIN(name) ((void) 0)
+#define TRACE_END() ((void) 0)
+
+#endif